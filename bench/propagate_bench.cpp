@@ -0,0 +1,56 @@
+// Error propagation through N frames of TRY, always failing at the bottom.
+// Built twice, with and without RESULT_TRACE; the difference between the
+// two binaries at a given depth is the cost of recording the return trace,
+// and the slope over depth is the per-hop cost.
+
+#include "result.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+#if defined(__GNUC__)
+#define BENCH_NOINLINE __attribute__((noinline))
+#else
+#define BENCH_NOINLINE
+#endif
+
+namespace {
+
+enum class Errc : std::uint32_t { bad = 1 };
+
+template<int N>
+BENCH_NOINLINE Result< int, Errc > frame(int x)
+{
+    if constexpr (N == 0)
+    {
+        if (x >= 0)
+            return Err(Errc::bad);
+        return Ok(x);
+    }
+    else
+    {
+        int v = TRY(frame< N - 1 >(x));
+        return Ok(v + 1);
+    }
+}
+
+template<int N>
+void BM_propagate_err(benchmark::State & state)
+{
+    int x = 1;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(x);
+        auto r = frame< N >(x);
+        benchmark::DoNotOptimize(r);
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_propagate_err, 1);
+BENCHMARK_TEMPLATE(BM_propagate_err, 4);
+BENCHMARK_TEMPLATE(BM_propagate_err, 8);
+BENCHMARK_TEMPLATE(BM_propagate_err, 16);
+BENCHMARK_TEMPLATE(BM_propagate_err, 32);
+
+} /* namespace */
@@ -0,0 +1,351 @@
+// Result against std::expected, integer return codes and exceptions on the
+// operations hot paths use: construction, is_ok/unwrap, propagating an error
+// through N frames at several failure rates, and map/and_then chains, eager
+// and fused. Propagation is also run through result_coro.hpp's co_await, the
+// portable alternative to TRY.
+//
+// Failure rates are per mille and apply per call; inputs are drawn up front
+// so that every variant sees the same sequence.
+
+#include "result.hpp"
+#include "result_coro.hpp"
+#include "result_lazy.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__has_include)
+#if __has_include(<expected>)
+#include <expected>
+#endif
+#endif
+
+#if defined(__GNUC__)
+#define BENCH_NOINLINE __attribute__((noinline))
+#else
+#define BENCH_NOINLINE
+#endif
+
+namespace {
+
+enum class Errc : std::uint32_t { bad = 1 };
+
+constexpr std::size_t input_count = 4096;
+
+// Inputs where a negative value makes the innermost frame fail
+std::vector< int > const& inputs(std::int64_t per_mille)
+{
+    static std::vector< int > cache[1001];
+    auto& in = cache[per_mille];
+    if (in.empty())
+    {
+        std::mt19937 rng(42);
+        std::uniform_int_distribution< int > pick(0, 999);
+        for (std::size_t i = 0; i < input_count; ++i)
+            in.push_back(pick(rng) < per_mille ? -1 : int(i));
+    }
+    return in;
+}
+
+void failure_rates(benchmark::internal::Benchmark * b)
+{
+    for (int depth : { 1, 4, 16 })
+        for (int rate : { 0, 10, 500 })
+            b->Args({ depth, rate });
+}
+
+// Result with TRY
+
+template<int N>
+BENCH_NOINLINE Result< int, Errc > result_frame(int x)
+{
+    if constexpr (N == 0)
+    {
+        if (x < 0)
+            return Err(Errc::bad);
+        return Ok(x);
+    }
+    else
+    {
+        int v = TRY(result_frame< N - 1 >(x));
+        return Ok(v + 1);
+    }
+}
+
+// Result with co_await
+
+template<int N>
+BENCH_NOINLINE Result< int, Errc > coro_frame(int x)
+{
+    if constexpr (N == 0)
+    {
+        if (x < 0)
+            co_return Err(Errc::bad);
+        co_return Ok(x);
+    }
+    else
+    {
+        int v = co_await coro_frame< N - 1 >(x);
+        co_return Ok(v + 1);
+    }
+}
+
+// Integer return code with an out parameter
+
+template<int N>
+BENCH_NOINLINE int code_frame(int x, int & out)
+{
+    if constexpr (N == 0)
+    {
+        if (x < 0)
+            return 1;
+        out = x;
+        return 0;
+    }
+    else
+    {
+        int v;
+        if (int rc = code_frame< N - 1 >(x, v))
+            return rc;
+        out = v + 1;
+        return 0;
+    }
+}
+
+// Exceptions
+
+template<int N>
+BENCH_NOINLINE int throw_frame(int x)
+{
+    if constexpr (N == 0)
+    {
+        if (x < 0)
+            throw std::runtime_error("bad");
+        return x;
+    }
+    else
+    {
+        return throw_frame< N - 1 >(x) + 1;
+    }
+}
+
+#if defined(__cpp_lib_expected)
+template<int N>
+BENCH_NOINLINE std::expected< int, Errc > expected_frame(int x)
+{
+    if constexpr (N == 0)
+    {
+        if (x < 0)
+            return std::unexpected(Errc::bad);
+        return x;
+    }
+    else
+    {
+        auto r = expected_frame< N - 1 >(x);
+        if (!r)
+            return std::unexpected(r.error());
+        return *r + 1;
+    }
+}
+#endif
+
+// Depths are template arguments, so dispatch on the runtime argument once
+template<template<int> class Frame>
+std::int64_t run_depth(benchmark::State & state)
+{
+    auto const& in = inputs(state.range(1));
+    std::int64_t sum = 0;
+    std::size_t i = 0;
+    switch (state.range(0))
+    {
+    case 1:
+        for (auto _ : state)
+            sum += Frame< 1 >::call(in[i++ % input_count]);
+        break;
+    case 4:
+        for (auto _ : state)
+            sum += Frame< 4 >::call(in[i++ % input_count]);
+        break;
+    default:
+        for (auto _ : state)
+            sum += Frame< 16 >::call(in[i++ % input_count]);
+        break;
+    }
+    return sum;
+}
+
+template<int N>
+struct ResultCall
+{
+    static int call(int x) { return result_frame< N >(x).unwrap_or(0); }
+};
+
+template<int N>
+struct CoroCall
+{
+    static int call(int x) { return coro_frame< N >(x).unwrap_or(0); }
+};
+
+template<int N>
+struct CodeCall
+{
+    static int call(int x)
+    {
+        int v = 0;
+        return code_frame< N >(x, v) ? 0 : v;
+    }
+};
+
+template<int N>
+struct ThrowCall
+{
+    static int call(int x)
+    {
+        try
+        {
+            return throw_frame< N >(x);
+        }
+        catch (std::runtime_error const&)
+        {
+            return 0;
+        }
+    }
+};
+
+#if defined(__cpp_lib_expected)
+template<int N>
+struct ExpectedCall
+{
+    static int call(int x) { return expected_frame< N >(x).value_or(0); }
+};
+#endif
+
+void BM_propagate_result(benchmark::State & state) { benchmark::DoNotOptimize(run_depth< ResultCall >(state)); }
+void BM_propagate_coro(benchmark::State & state) { benchmark::DoNotOptimize(run_depth< CoroCall >(state)); }
+void BM_propagate_code(benchmark::State & state) { benchmark::DoNotOptimize(run_depth< CodeCall >(state)); }
+void BM_propagate_exception(benchmark::State & state) { benchmark::DoNotOptimize(run_depth< ThrowCall >(state)); }
+
+BENCHMARK(BM_propagate_result)->Apply(failure_rates);
+BENCHMARK(BM_propagate_coro)->Apply(failure_rates);
+BENCHMARK(BM_propagate_code)->Apply(failure_rates);
+BENCHMARK(BM_propagate_exception)->Apply(failure_rates);
+
+#if defined(__cpp_lib_expected)
+void BM_propagate_expected(benchmark::State & state) { benchmark::DoNotOptimize(run_depth< ExpectedCall >(state)); }
+BENCHMARK(BM_propagate_expected)->Apply(failure_rates);
+#endif
+
+// Construction and access
+
+void BM_construct_ok(benchmark::State & state)
+{
+    int x = 1;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(x);
+        Result< int, Errc > r = Ok(x);
+        benchmark::DoNotOptimize(r);
+    }
+}
+BENCHMARK(BM_construct_ok);
+
+void BM_construct_err(benchmark::State & state)
+{
+    Errc e = Errc::bad;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(e);
+        Result< int, Errc > r = Err(e);
+        benchmark::DoNotOptimize(r);
+    }
+}
+BENCHMARK(BM_construct_err);
+
+void BM_is_ok_unwrap(benchmark::State & state)
+{
+    auto const& in = inputs(state.range(0));
+    std::vector< Result< int, Errc > > results;
+    for (int x : in)
+        results.push_back(result_frame< 0 >(x));
+    for (auto _ : state)
+    {
+        std::int64_t sum = 0;
+        for (auto const& r : results)
+            if (r.is_ok())
+                sum += r.unwrap();
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * std::int64_t(results.size()));
+}
+BENCHMARK(BM_is_ok_unwrap)->Arg(0)->Arg(10)->Arg(500);
+
+#if defined(__cpp_lib_expected)
+void BM_expected_has_value(benchmark::State & state)
+{
+    auto const& in = inputs(state.range(0));
+    std::vector< std::expected< int, Errc > > results;
+    for (int x : in)
+        results.push_back(expected_frame< 0 >(x));
+    for (auto _ : state)
+    {
+        std::int64_t sum = 0;
+        for (auto const& r : results)
+            if (r.has_value())
+                sum += *r;
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * std::int64_t(results.size()));
+}
+BENCHMARK(BM_expected_has_value)->Arg(0)->Arg(10)->Arg(500);
+#endif
+
+// Six-stage pipelines, eager and fused
+
+BENCH_NOINLINE Result< int, Errc > validate(int x)
+{
+    if (x > 1000000)
+        return Err(Errc::bad);
+    return Ok(x);
+}
+
+void BM_chain_eager(benchmark::State & state)
+{
+    auto const& in = inputs(state.range(0));
+    std::size_t i = 0;
+    for (auto _ : state)
+    {
+        auto r = result_frame< 0 >(in[i++ % input_count])
+            .map([](int x) { return x + 1; })
+            .and_then(validate)
+            .map([](int x) { return x * 3; })
+            .and_then(validate)
+            .map([](int x) { return x - 2; })
+            .map_err([](Errc e) { return int(e); });
+        benchmark::DoNotOptimize(r);
+    }
+}
+BENCHMARK(BM_chain_eager)->Arg(0)->Arg(10)->Arg(500);
+
+void BM_chain_lazy(benchmark::State & state)
+{
+    auto const& in = inputs(state.range(0));
+    std::size_t i = 0;
+    for (auto _ : state)
+    {
+        Result< int, int > r = result_frame< 0 >(in[i++ % input_count]).lazy()
+            | lazy::map([](int x) { return x + 1; })
+            | lazy::and_then(validate)
+            | lazy::map([](int x) { return x * 3; })
+            | lazy::and_then(validate)
+            | lazy::map([](int x) { return x - 2; })
+            | lazy::map_err([](Errc e) { return int(e); });
+        benchmark::DoNotOptimize(r);
+    }
+}
+BENCHMARK(BM_chain_lazy)->Arg(0)->Arg(10)->Arg(500);
+
+} /* namespace */
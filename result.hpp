@@ -1,11 +1,168 @@
 #pragma once
 
+#include "result_fwd.hpp"
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
 #include <exception>
-#include <functional>
+#include <memory>
+#include <new>
 #include <optional>
+#include <stdexcept>
+#include <string>
 #include <string_view>
 #include <type_traits>
-#include <variant>
+#include <utility>
+
+#if defined(__has_include) && __cplusplus >= 202002L
+#if __has_include(<compare>)
+#include <compare>
+#endif
+#if __has_include(<source_location>)
+#include <source_location>
+#endif
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#define RESULT_NO_UNIQUE_ADDRESS [[msvc::no_unique_address]]
+#elif defined(__has_cpp_attribute)
+#if __has_cpp_attribute(no_unique_address)
+#define RESULT_NO_UNIQUE_ADDRESS [[no_unique_address]]
+#endif
+#endif
+#ifndef RESULT_NO_UNIQUE_ADDRESS
+#define RESULT_NO_UNIQUE_ADDRESS
+#endif
+
+#if defined(__GNUC__)
+#define RESULT_LIKELY(x) __builtin_expect(!!(x), 1)
+#define RESULT_UNLIKELY(x) __builtin_expect(!!(x), 0)
+#define RESULT_COLD __attribute__((cold, noinline))
+#elif defined(_MSC_VER)
+#define RESULT_LIKELY(x) (x)
+#define RESULT_UNLIKELY(x) (x)
+#define RESULT_COLD __declspec(noinline)
+#else
+#define RESULT_LIKELY(x) (x)
+#define RESULT_UNLIKELY(x) (x)
+#define RESULT_COLD
+#endif
+
+// Destructors can only be constexpr from C++20 on
+#if defined(__cpp_constexpr_dynamic_alloc)
+#define RESULT_CONSTEXPR_DTOR constexpr
+#else
+#define RESULT_CONSTEXPR_DTOR
+#endif
+
+#if defined(__cpp_exceptions) || defined(_CPPUNWIND)
+#define RESULT_HAS_EXCEPTIONS 1
+#else
+#define RESULT_HAS_EXCEPTIONS 0
+#endif
+
+// Panic policy for unwrap/expect on the wrong alternative. Define one of
+// these before including the header:
+//
+//   RESULT_PANIC_THROW          throw std::logic_error (default with exceptions)
+//   RESULT_PANIC_ABORT          print the message and std::abort() (default without)
+//   RESULT_PANIC_UNREACHABLE    treat the failure as undefined behaviour
+//   RESULT_PANIC_HANDLER=fn     call [[noreturn]] void fn(std::string_view) noexcept,
+//                               which must be declared before including
+//
+// With any policy but RESULT_PANIC_THROW the panicking accessors are noexcept.
+#if !defined(RESULT_PANIC_THROW) && !defined(RESULT_PANIC_ABORT) && \
+    !defined(RESULT_PANIC_UNREACHABLE) && !defined(RESULT_PANIC_HANDLER)
+#if RESULT_HAS_EXCEPTIONS
+#define RESULT_PANIC_THROW
+#else
+#define RESULT_PANIC_ABORT
+#endif
+#endif
+
+// Unchecked accessors (unwrap_unchecked, operator*, ...) trust the caller
+// about the active alternative. With RESULT_CHECK_UNCHECKED, on unless
+// NDEBUG is defined, an access to the wrong alternative is reported with
+// the caller's source location and aborts; RESULT_UNCHECKED_HANDLER=fn
+// replaces the report with a call to
+//
+//   [[noreturn]] void fn(std::string_view what, char const * file, unsigned line) noexcept
+//
+// Without checks the active alternative becomes an optimizer assumption
+// and a wrong access is undefined behaviour.
+#if !defined(RESULT_CHECK_UNCHECKED)
+#if defined(NDEBUG)
+#define RESULT_CHECK_UNCHECKED 0
+#else
+#define RESULT_CHECK_UNCHECKED 1
+#endif
+#endif
+
+#if defined(__has_cpp_attribute)
+#if __has_cpp_attribute(assume) >= 202207L
+#define RESULT_ASSUME(x) [[assume(x)]]
+#endif
+#endif
+#if !defined(RESULT_ASSUME)
+#if defined(__clang__)
+#define RESULT_ASSUME(x) __builtin_assume(x)
+#elif defined(__GNUC__)
+#define RESULT_ASSUME(x) do { if (!(x)) __builtin_unreachable(); } while (0)
+#elif defined(_MSC_VER)
+#define RESULT_ASSUME(x) __assume(x)
+#else
+#define RESULT_ASSUME(x) ((void)0)
+#endif
+#endif
+
+// RESULT_TRACE keeps a return trace next to every error: Err(...) records
+// its call site and each TRY, TRY_VOID and TRY_ASSIGN that propagates the
+// error appends its own, readable through Result::return_trace(). The
+// untouched error of a combinator keeps its trace, map_err and context
+// carry it over to the new error. Errors grow by the trace, and niche
+// packing is off in this mode. RESULT_TRACE_DEPTH (a power of two, 8 by
+// default) bounds the hops kept.
+#if defined(RESULT_TRACE) && !defined(RESULT_TRACE_DEPTH)
+#define RESULT_TRACE_DEPTH 8
+#endif
+
+// Customization point for types with a spare bit pattern that never occurs
+// as a real payload (non-null handles, enums with an unused enumerator,
+// ...). When one side of a Result has a niche and the other side is an
+// empty type, the discriminant is stored in the niche and the Result is
+// exactly the size of the niche type. A specialization provides:
+//
+//   static constexpr bool has_niche = true;
+//   static constexpr T niche();                  // the spare value
+//   static constexpr bool is_niche(T const& t);  // t holds the spare value
+//
+// Copies and moves of the spare value must again compare as the niche.
+// Raw pointers have no niche by default since Ok(nullptr) is a valid
+// payload; specialize niche_traits< Node * > to opt in.
+template<typename T>
+struct niche_traits
+{
+    static constexpr bool has_niche = false;
+};
+
+// Customization point for payloads that can move to a new address by a
+// copy of their bytes, with the source then left undestroyed. Trivially
+// copyable types qualify by default; most types owning a heap pointer do
+// too, but self-referencing ones (libstdc++'s std::string, for one) do not.
+// Specialize to opt a type in:
+//
+//   template<> struct is_trivially_relocatable< Frame > : std::true_type {};
+//
+// DynError moves such errors between inline buffers with a memcpy.
+template<typename T>
+struct is_trivially_relocatable : std::is_trivially_copyable< T > {};
+
+template<typename T>
+struct is_trivially_relocatable< std::unique_ptr< T > > : std::true_type {};
+
+template<typename T>
+constexpr bool is_trivially_relocatable_v = is_trivially_relocatable< T >::value;
 
 namespace details {
 
@@ -15,9 +172,162 @@ constexpr bool is_equiv_v = std::is_same_v<
     std::decay_t< U >
 >;
 
+// Stand-in payload for the void side of Result<void, E> and Result<T, void>
+struct Unit
+{
+    friend constexpr bool operator==(Unit, Unit) { return true; }
+    friend constexpr bool operator!=(Unit, Unit) { return false; }
+    friend constexpr bool operator<(Unit, Unit) { return false; }
+    friend constexpr bool operator>(Unit, Unit) { return false; }
+    friend constexpr bool operator<=(Unit, Unit) { return true; }
+    friend constexpr bool operator>=(Unit, Unit) { return true; }
+};
+
+template<typename T>
+using value_t = std::conditional_t< std::is_void_v< T >, Unit, T >;
+
+// Invocation of Fn with a payload of type A, where a void payload means
+// calling Fn with no arguments.
+template<typename Fn, typename A>
+struct call_result { using type = std::invoke_result_t< Fn, A >; };
+
+template<typename Fn>
+struct call_result< Fn, void > { using type = std::invoke_result_t< Fn >; };
+
+template<typename Fn, typename A>
+using call_result_t = typename call_result< Fn, A >::type;
+
+// The object a pointer to a member of C applies to: o itself for a C, what
+// it points to for pointers and smart pointers, and o.get() otherwise (a
+// std::reference_wrapper)
+template<typename C, typename Obj, typename = void>
+struct member_object
+{
+    static constexpr decltype(auto) get(Obj&& o) { return o.get(); }
+};
+
+template<typename C, typename Obj>
+struct member_object< C, Obj, std::enable_if_t< !std::is_base_of_v< C, std::decay_t< Obj > > &&
+    std::is_void_v< std::void_t< decltype(*std::declval< Obj >()) > > > >
+{
+    static constexpr decltype(auto) get(Obj&& o) { return *std::forward< Obj >(o); }
+};
+
+template<typename C, typename Obj>
+struct member_object< C, Obj, std::enable_if_t< std::is_base_of_v< C, std::decay_t< Obj > > > >
+{
+    static constexpr Obj&& get(Obj&& o) { return std::forward< Obj >(o); }
+};
+
+template<typename M, typename C, typename Obj, typename... Args>
+constexpr decltype(auto) invoke_member(M C::* pm, Obj&& o, Args&&... args)
+{
+    if constexpr (std::is_function_v< M >)
+        return (member_object< C, Obj >::get(std::forward< Obj >(o)).*pm)(std::forward< Args >(args)...);
+    else
+        return (member_object< C, Obj >::get(std::forward< Obj >(o)).*pm);
+}
+
+// std::invoke without <functional>, and usable in constant expressions
+// before C++20
+template<typename Fn, typename... Args>
+constexpr decltype(auto) invoke(Fn&& fn, Args&&... args)
+{
+    if constexpr (std::is_member_pointer_v< std::decay_t< Fn > >)
+        return details::invoke_member(fn, std::forward< Args >(args)...);
+    else
+        return std::forward< Fn >(fn)(std::forward< Args >(args)...);
+}
+
+// A qualified like the object expression Self: A& or A const& for lvalues,
+// A&& for rvalues. A void payload stays void.
+template<typename Self, typename A>
+struct like
+{
+    using type = std::conditional_t< std::is_lvalue_reference_v< Self >,
+        std::conditional_t< std::is_const_v< std::remove_reference_t< Self > >, A const&, A& >,
+        A&&
+    >;
+};
+
+template<typename Self>
+struct like< Self, void > { using type = void; };
+
+template<typename Self, typename A>
+using like_t = typename like< Self, A >::type;
+
 template<typename R, typename Fn, typename A>
 constexpr bool is_op_v = std::is_invocable_r_v< R, Fn, A >;
 
+template<typename R, typename Fn>
+constexpr bool is_op_v< R, Fn, void > = std::is_invocable_r_v< R, Fn >;
+
+// Call site captured through a defaulted argument, for error payloads
+// that record where they were raised. Uses std::source_location when the
+// library has it and the equivalent builtins otherwise.
+struct SourceLocation
+{
+    char const * file = "";
+    char const * function = "";
+    unsigned line = 0;
+
+#if defined(__cpp_lib_source_location)
+    static constexpr SourceLocation current(
+        std::source_location loc = std::source_location::current()) noexcept
+    {
+        return SourceLocation{ loc.file_name(), loc.function_name(), static_cast< unsigned >(loc.line()) };
+    }
+#elif defined(__GNUC__) || defined(_MSC_VER)
+    static constexpr SourceLocation current(
+        char const * file = __builtin_FILE(),
+        char const * function = __builtin_FUNCTION(),
+        unsigned line = __builtin_LINE()) noexcept
+    {
+        return SourceLocation{ file, function, line };
+    }
+#else
+    static constexpr SourceLocation current() noexcept { return SourceLocation{}; }
+#endif
+};
+
+#if defined(RESULT_TRACE)
+// Where an error was raised and the TRY hops it has since been returned
+// through: the origin plus a ring of the last RESULT_TRACE_DEPTH hops.
+// Each hop costs one store of a SourceLocation and an increment.
+class ReturnTrace
+{
+    static constexpr unsigned depth = RESULT_TRACE_DEPTH;
+    static_assert(depth != 0 && (depth & (depth - 1)) == 0,
+        "RESULT_TRACE_DEPTH must be a power of two");
+
+    SourceLocation origin_{};
+    SourceLocation hops_[depth] = {};
+    unsigned count_ = 0;
+
+public:
+    constexpr ReturnTrace() = default;
+    constexpr explicit ReturnTrace(SourceLocation origin) : origin_(origin) {}
+
+    // Err(...) call that created the error; empty if it was built in place
+    constexpr SourceLocation const& origin() const { return origin_; }
+
+    // Hops kept in the ring and hops that have fallen out of it
+    constexpr unsigned size() const { return count_ < depth ? count_ : depth; }
+    constexpr unsigned dropped() const { return count_ - size(); }
+
+    // Kept hop i, oldest first
+    constexpr SourceLocation const& operator[](unsigned i) const { return hops_[(dropped() + i) & (depth - 1)]; }
+
+    constexpr void push(SourceLocation loc)
+    {
+        hops_[count_ & (depth - 1)] = loc;
+        ++count_;
+    }
+};
+
+struct TraceTag {};
+#endif
+
 struct OkBase {};
 struct ErrBase {};
 struct ResultBase {};
@@ -45,9 +355,11 @@ struct Ok : details::OkBase
 {
     T t_;
 
-    constexpr Ok(T t) : t_(std::move(t)) {}
+    template<typename U = T, typename = std::enable_if_t<
+        !is_ok_v< U > && std::is_constructible_v< T, U&& > > >
+    constexpr Ok(U&& u) : t_(std::forward< U >(u)) {}
     template<typename U>
-    constexpr Ok(Ok< U > ok) : t_(std::move(ok.t_)) {}
+    constexpr Ok(Ok< U > ok) : t_(static_cast< U&& >(ok.t_)) {}
 };
 
 
@@ -55,261 +367,1830 @@ template<typename E>
 struct Err : details::ErrBase
 {
     E e_;
+#if defined(RESULT_TRACE)
+    ReturnTrace trace_;
+#endif
 
-    constexpr Err(E e) : e_(std::move(e)) {}
+    template<typename F = E, typename = std::enable_if_t< 
+        !is_err_v< F > && std::is_constructible_v< E, F&& > > >
+    constexpr Err(F&& f) : e_(std::forward< F >(f)) {}
+#if defined(RESULT_TRACE)
+    template<typename F>
+    constexpr Err(ReturnTrace const& trace, F&& f) : e_(std::forward< F >(f)), trace_(trace) {}
+    template<typename F>
+    constexpr Err(Err< F > err) : e_(static_cast< F&& >(err.e_)), trace_(err.trace_) {}
+#else
     template<typename F>
-    constexpr Err(Err< F > err) : e_(std::move(err.e_)) {}
+    constexpr Err(Err< F > err) : e_(static_cast< F&& >(err.e_)) {}
+#endif
 };
 
-} /* namespace details */
+// Err holding a G that takes over the return trace of src in RESULT_TRACE
+// builds, for stages that replace an error outside of a Result
+template<typename G, typename E, typename F>
+constexpr Err< G > rewrap_err(Err< E > const& src, F&& f)
+{
+#if defined(RESULT_TRACE)
+    return Err< G >(src.trace_, std::forward< F >(f));
+#else
+    (void)src;
+    return Err< G >(std::forward< F >(f));
+#endif
+}
 
+struct OkTag {};
+struct ErrTag {};
+struct NoInitTag {};
 
-template<typename T>
-constexpr auto Ok(T&& t)
+struct TryAccess;
+
+#if defined(RESULT_PANIC_THROW)
+constexpr bool panic_noexcept = false;
+#else
+constexpr bool panic_noexcept = true;
+#endif
+
+[[noreturn]] RESULT_COLD inline void panic(std::string_view msg) noexcept(panic_noexcept)
 {
-    using CleanT = std::decay_t< T >;
-    return details::Ok< CleanT >(std::forward< T >(t));
+#if defined(RESULT_PANIC_THROW)
+    throw std::logic_error{ std::string(msg) };
+#elif defined(RESULT_PANIC_ABORT)
+    std::fwrite(msg.data(), 1, msg.size(), stderr);
+    std::fputc('\n', stderr);
+    std::abort();
+#elif defined(RESULT_PANIC_UNREACHABLE)
+    (void)msg;
+#if defined(__GNUC__)
+    __builtin_unreachable();
+#elif defined(_MSC_VER)
+    __assume(0);
+#else
+    std::abort();
+#endif
+#else
+    RESULT_PANIC_HANDLER(msg);
+#endif
 }
 
-template<typename E>
-constexpr auto Err(E&& e)
+template<typename T, typename... Args>
+constexpr T * construct_at(T * p, Args&&... args)
 {
-    using CleanE = std::decay_t< E >;
-    return details::Err< CleanE >(std::forward< E >(e));
+#if defined(__cpp_lib_constexpr_dynamic_alloc)
+    return std::construct_at(p, std::forward< Args >(args)...);
+#else
+    return ::new (static_cast< void * >(p)) T(std::forward< Args >(args)...);
+#endif
 }
 
 
-template<typename T, typename E>
-class Result : details::ResultBase
+#if defined(RESULT_INSTRUMENT)
+// Hooks defined in result_instrument.hpp
+inline void instrument_err(SourceLocation loc) noexcept;
+inline void instrument_try(SourceLocation loc) noexcept;
+
+// Instrumentation is skipped during constant evaluation
+constexpr bool in_constant_evaluation() noexcept
 {
-    using ResT = Result< T, E >;
-    using OkT  = details::Ok< T >;
-    using ErrE = details::Err< E >;
+#if defined(__cpp_lib_is_constant_evaluated)
+    return std::is_constant_evaluated();
+#elif defined(__GNUC__)
+    return __builtin_is_constant_evaluated();
+#else
+    return false;
+#endif
+}
+
+#define RESULT_INSTRUMENT_(hook, loc) \
+    (::details::in_constant_evaluation() ? void() : ::details::hook(loc))
+#define RESULT_INSTRUMENT_TRY_AT_(loc) RESULT_INSTRUMENT_(instrument_try, loc)
+#else
+#define RESULT_INSTRUMENT_TRY_AT_(loc) ((void)0)
+#endif
+#define RESULT_INSTRUMENT_TRY_() RESULT_INSTRUMENT_TRY_AT_(::details::SourceLocation::current())
+
+#if RESULT_CHECK_UNCHECKED
+[[noreturn]] RESULT_COLD inline void unchecked_violation(std::string_view what, SourceLocation loc) noexcept
+{
+#if defined(RESULT_UNCHECKED_HANDLER)
+    RESULT_UNCHECKED_HANDLER(what, loc.file, loc.line);
+#else
+    std::fprintf(stderr, "%s:%u: %s: %.*s\n", loc.file, loc.line, loc.function,
+        static_cast< int >(what.size()), what.data());
+    std::abort();
+#endif
+}
+#endif
+
+// std::destroy_at is only constexpr from C++20 on; trivially destructible
+// payloads skip the call so they stay usable in constant expressions.
+template<typename T>
+constexpr void destroy_at(T * p)
+{
+    if constexpr (!std::is_trivially_destructible_v< T >)
+        p->~T();
+}
 
-    std::variant< OkT, ErrE > variant_;
+// Non-null holder standing in for a T& payload, so references can live
+// in a union and rebind on assignment.
+template<typename T>
+class Ref
+{
+    T * p_;
 
 public:
-    template<typename U>
-    constexpr Result(details::Ok< U > ok) : variant_{ OkT( std::move(ok.t_) ) } {}
+    constexpr Ref(T & t) : p_(std::addressof(t)) {}
+    constexpr explicit Ref(std::nullptr_t) : p_(nullptr) {}
 
-    template<typename F>
-    constexpr Result(details::Err< F > err) : variant_{ ErrE( std::move(err.e_) ) } {}
+    constexpr T & get() const { return *p_; }
+    constexpr bool is_null() const { return p_ == nullptr; }
+};
 
-    // Make movable
-    constexpr Result(Result&&) = default;
-    constexpr Result& operator=(Result&&) = default;
+template<typename T>
+struct Stored
+{
+    using type = T;
+    static constexpr T & get(T & t) { return t; }
+    static constexpr T const& get(T const& t) { return t; }
+};
 
-    // Make non-default constructable
-    Result() = delete;
-    // Make non-copyable
-    Result(Result const&) = delete;
-    Result& operator=(Result const&) = delete;
+template<typename T>
+struct Stored< T & >
+{
+    using type = Ref< T >;
+    static constexpr T & get(Ref< T > const& r) { return r.get(); }
+};
 
-    // API
-    constexpr bool is_ok() const { return std::holds_alternative< OkT >(variant_); }
-    constexpr bool is_err() const { return std::holds_alternative< ErrE >(variant_); }
+template<typename T>
+using stored_t = typename Stored< T >::type;
+
+// Raw union of the two stored types. The none_ member lets copy and move
+// constructors start from an empty union and fill it in afterwards.
+template<typename A, typename B,
+    bool = std::is_trivially_destructible_v< A > && std::is_trivially_destructible_v< B > >
+union Union
+{
+    char none_;
+    A a_;
+    B b_;
+
+    constexpr Union(NoInitTag) : none_() {}
+    template<typename... Args>
+    constexpr Union(OkTag, Args&&... args) : a_(std::forward< Args >(args)...) {}
+    template<typename... Args>
+    constexpr Union(ErrTag, Args&&... args) : b_(std::forward< Args >(args)...) {}
+};
+
+template<typename A, typename B>
+union Union< A, B, false >
+{
+    char none_;
+    A a_;
+    B b_;
+
+    constexpr Union(NoInitTag) : none_() {}
+    template<typename... Args>
+    constexpr Union(OkTag, Args&&... args) : a_(std::forward< Args >(args)...) {}
+    template<typename... Args>
+    constexpr Union(ErrTag, Args&&... args) : b_(std::forward< Args >(args)...) {}
+
+    Union(Union const&) = default;
+    Union(Union&&) = default;
+    Union& operator=(Union const&) = default;
+    Union& operator=(Union&&) = default;
+    RESULT_CONSTEXPR_DTOR ~Union() {}
+};
+
+// Tagged union holding either a T or an E, with a one-byte discriminant.
+// Accessors are unchecked; callers are expected to have tested has_ok().
+// The special members are supplied by the layers below, so that each one
+// is trivial whenever it is trivial for both T and E.
+template<typename T, typename E>
+class TaggedBase
+{
+protected:
+    using ST = stored_t< T >;
+    using SE = stored_t< E >;
 
-    constexpr std::optional< T > ok()
+    Union< ST, SE > u_;
+    bool ok_;
+
+    // Trivial payloads are replaced by assigning a whole union, which also
+    // switches the active member in C++17 constant evaluation, where
+    // placement new is not allowed
+    static constexpr bool assign_union_ =
+        std::is_trivially_copy_assignable_v< Union< ST, SE > > &&
+        std::is_trivially_destructible_v< Union< ST, SE > >;
+
+    constexpr TaggedBase(NoInitTag) : u_(NoInitTag{}), ok_(false) {}
+
+public:
+    template<typename... Args>
+    constexpr TaggedBase(OkTag, Args&&... args) 
+        : u_(OkTag{}, std::forward< Args >(args)...), ok_(true) {}
+
+    template<typename... Args>
+    constexpr TaggedBase(ErrTag, Args&&... args) 
+        : u_(ErrTag{}, std::forward< Args >(args)...), ok_(false) {}
+
+    constexpr bool has_ok() const { return ok_; }
+
+    constexpr T & t() { return Stored< T >::get(u_.a_); }
+    constexpr T const& t() const { return Stored< T >::get(u_.a_); }
+    constexpr E & e() { return Stored< E >::get(u_.b_); }
+    constexpr E const& e() const { return Stored< E >::get(u_.b_); }
+
+    template<typename... Args>
+    constexpr T & emplace_t(Args&&... args)
     {
-        if (is_ok())
-            return move_t_();
+        if constexpr (assign_union_)
+            u_ = Union< ST, SE >(OkTag{}, std::forward< Args >(args)...);
+        else if (ok_)
+            reinit_(&u_.a_, &u_.a_, std::forward< Args >(args)...);
         else
-            return {};
+            reinit_(&u_.a_, &u_.b_, std::forward< Args >(args)...);
+        ok_ = true;
+        return t();
     }
 
-    constexpr std::optional< E > err()
+    template<typename... Args>
+    constexpr E & emplace_e(Args&&... args)
     {
-        if (is_err())
-            return move_e_();
+        if constexpr (assign_union_)
+            u_ = Union< ST, SE >(ErrTag{}, std::forward< Args >(args)...);
+        else if (ok_)
+            reinit_(&u_.b_, &u_.a_, std::forward< Args >(args)...);
         else
-            return {};
+            reinit_(&u_.b_, &u_.b_, std::forward< Args >(args)...);
+        ok_ = false;
+        return e();
     }
 
-    constexpr T unwrap()
+protected:
+    template<typename Other>
+    constexpr void construct_from_(Other&& other)
     {
-        if (is_ok())
-            return move_t_();
+        if (other.ok_)
+            details::construct_at(&u_.a_, std::forward< Other >(other).u_.a_);
         else
-            throw std::logic_error{ "Result::unwrap panicked" };
+            details::construct_at(&u_.b_, std::forward< Other >(other).u_.b_);
+        ok_ = other.ok_;
     }
 
-    constexpr E unwrap_err()
+    template<typename Other>
+    constexpr void assign_from_(Other&& other)
     {
-        if (is_err())
-            return move_e_();
+        if (ok_ && other.ok_)
+            u_.a_ = std::forward< Other >(other).u_.a_;
+        else if (!ok_ && !other.ok_)
+            u_.b_ = std::forward< Other >(other).u_.b_;
+        else if (other.ok_)
+            reinit_(&u_.a_, &u_.b_, std::forward< Other >(other).u_.a_);
         else
-            throw std::logic_error{ "Result::unwrawp_err panicked" };
+            reinit_(&u_.b_, &u_.a_, std::forward< Other >(other).u_.b_);
+        ok_ = other.ok_;
     }
 
-    template<typename U>
-    constexpr T unwrap_or(U&& default_value)
+    constexpr void destroy_()
     {
-        static_assert(details::is_equiv_v< T, U >, 
-            "Default value type is not equivalent to Ok type");
-        if (is_ok())
-            return move_t_();
+        if (ok_)
+            details::destroy_at(&u_.a_);
         else
-            return std::forward< U >(default_value);
+            details::destroy_at(&u_.b_);
     }
 
-    template<typename Fn>
-    constexpr T unwrap_or_else(Fn& fn)
+private:
+    // Replace the active member *old with a New built from args, leaving
+    // *old intact if construction throws.
+    template<typename New, typename Old, typename... Args>
+    static constexpr void reinit_(New * new_p, Old * old_p, Args&&... args)
     {
-        static_assert(details::is_op_v< T, Fn, E >,
-            "Function is not of signature Fn(E) -> T");
-        if (is_ok())
-            return move_t_();
+        if constexpr (std::is_nothrow_constructible_v< New, Args... >)
+        {
+            details::destroy_at(old_p);
+            details::construct_at(new_p, std::forward< Args >(args)...);
+        }
+        else if constexpr (std::is_nothrow_move_constructible_v< New >)
+        {
+            New tmp(std::forward< Args >(args)...);
+            details::destroy_at(old_p);
+            details::construct_at(new_p, std::move(tmp));
+        }
         else
-            return fn(move_e_());
+        {
+#if defined(__cpp_lib_is_constant_evaluated)
+            // Nothing throws during constant evaluation
+            if (std::is_constant_evaluated())
+            {
+                details::destroy_at(old_p);
+                details::construct_at(new_p, std::forward< Args >(args)...);
+                return;
+            }
+#endif
+            reinit_guarded_(new_p, old_p, std::forward< Args >(args)...);
+        }
     }
 
-    constexpr T unwrap_or_default()
+    template<typename New, typename Old, typename... Args>
+    static void reinit_guarded_(New * new_p, Old * old_p, Args&&... args)
     {
-        if (is_ok())
-            return move_t_();
-        else
-            return T();
+        static_assert(std::is_nothrow_move_constructible_v< Old >,
+            "Either Ok or Err type must be nothrow move constructible");
+        Old tmp(std::move(*old_p));
+        details::destroy_at(old_p);
+#if RESULT_HAS_EXCEPTIONS
+        try
+        {
+            details::construct_at(new_p, std::forward< Args >(args)...);
+        }
+        catch (...)
+        {
+            details::construct_at(old_p, std::move(tmp));
+            throw;
+        }
+#else
+        details::construct_at(new_p, std::forward< Args >(args)...);
+#endif
     }
+};
+
+enum class Special { trivial, defined, deleted };
+
+template<bool Trivial, bool Possible>
+constexpr Special special_v = Trivial ? Special::trivial
+                            : Possible ? Special::defined
+                            : Special::deleted;
+
+template<typename A, typename B>
+constexpr Special dtor_v = special_v<
+    std::is_trivially_destructible_v< A > && std::is_trivially_destructible_v< B >,
+    true
+>;
+
+template<typename A, typename B>
+constexpr Special copy_ctor_v = special_v<
+    std::is_trivially_copy_constructible_v< A > && std::is_trivially_copy_constructible_v< B >,
+    std::is_copy_constructible_v< A > && std::is_copy_constructible_v< B >
+>;
+
+template<typename A, typename B>
+constexpr Special move_ctor_v = special_v<
+    std::is_trivially_move_constructible_v< A > && std::is_trivially_move_constructible_v< B >,
+    std::is_move_constructible_v< A > && std::is_move_constructible_v< B >
+>;
+
+template<typename A, typename B>
+constexpr Special copy_assign_v = special_v<
+    copy_ctor_v< A, B > == Special::trivial && dtor_v< A, B > == Special::trivial &&
+    std::is_trivially_copy_assignable_v< A > && std::is_trivially_copy_assignable_v< B >,
+    copy_ctor_v< A, B > != Special::deleted &&
+    std::is_copy_assignable_v< A > && std::is_copy_assignable_v< B >
+>;
+
+template<typename A, typename B>
+constexpr Special move_assign_v = special_v<
+    move_ctor_v< A, B > == Special::trivial && dtor_v< A, B > == Special::trivial &&
+    std::is_trivially_move_assignable_v< A > && std::is_trivially_move_assignable_v< B >,
+    move_ctor_v< A, B > != Special::deleted &&
+    std::is_move_assignable_v< A > && std::is_move_assignable_v< B >
+>;
+
+#define RESULT_DEFAULT_SPECIALS_(Layer) \
+    Layer(Layer const&) = default; \
+    Layer(Layer&&) = default; \
+    Layer& operator=(Layer const&) = default; \
+    Layer& operator=(Layer&&) = default
+
+template<typename Base, Special = Special::trivial>
+struct DtorLayer : Base
+{
+    using Base::Base;
+};
+
+template<typename Base>
+struct DtorLayer< Base, Special::defined > : Base
+{
+    using Base::Base;
+    RESULT_DEFAULT_SPECIALS_(DtorLayer);
+    RESULT_CONSTEXPR_DTOR ~DtorLayer() { this->destroy_(); }
+};
 
-    constexpr T expect(std::string_view msg)
+template<typename Base, Special = Special::trivial>
+struct CopyCtorLayer : Base
+{
+    using Base::Base;
+};
+
+template<typename Base>
+struct CopyCtorLayer< Base, Special::defined > : Base
+{
+    using Base::Base;
+    constexpr CopyCtorLayer(CopyCtorLayer const& other) : Base(NoInitTag{})
     {
-        if (is_ok())
-            return move_t_();
-        else
-            throw std::logic_error( msg );
+        this->construct_from_(other);
     }
+    CopyCtorLayer(CopyCtorLayer&&) = default;
+    CopyCtorLayer& operator=(CopyCtorLayer const&) = default;
+    CopyCtorLayer& operator=(CopyCtorLayer&&) = default;
+};
+
+template<typename Base>
+struct CopyCtorLayer< Base, Special::deleted > : Base
+{
+    using Base::Base;
+    CopyCtorLayer(CopyCtorLayer const&) = delete;
+    CopyCtorLayer(CopyCtorLayer&&) = default;
+    CopyCtorLayer& operator=(CopyCtorLayer const&) = default;
+    CopyCtorLayer& operator=(CopyCtorLayer&&) = default;
+};
+
+template<typename Base, Special = Special::trivial>
+struct MoveCtorLayer : Base
+{
+    using Base::Base;
+};
 
-    constexpr E expect_err(std::string_view msg)
+template<typename Base>
+struct MoveCtorLayer< Base, Special::defined > : Base
+{
+    using Base::Base;
+    MoveCtorLayer(MoveCtorLayer const&) = default;
+    constexpr MoveCtorLayer(MoveCtorLayer&& other) noexcept(
+        std::is_nothrow_move_constructible_v< typename Base::ST > &&
+        std::is_nothrow_move_constructible_v< typename Base::SE >)
+        : Base(NoInitTag{})
     {
-        if (is_err())
-            return move_e_();
-        else
-            throw std::logic_error( msg );
+        this->construct_from_(std::move(other));
     }
+    MoveCtorLayer& operator=(MoveCtorLayer const&) = default;
+    MoveCtorLayer& operator=(MoveCtorLayer&&) = default;
+};
 
-    template<typename Fn, typename U = std::invoke_result_t< Fn, T > >
-    constexpr Result< U, E > map(Fn&& fn)
-    {
-        static_assert(details::is_op_v< U, Fn, T >,
-            "Function is not of signature Fn(T) -> U");
+template<typename Base>
+struct MoveCtorLayer< Base, Special::deleted > : Base
+{
+    using Base::Base;
+    MoveCtorLayer(MoveCtorLayer const&) = default;
+    MoveCtorLayer(MoveCtorLayer&&) = delete;
+    MoveCtorLayer& operator=(MoveCtorLayer const&) = default;
+    MoveCtorLayer& operator=(MoveCtorLayer&&) = default;
+};
 
-        if (is_ok())
-            return Ok( fn(move_t_()) );
-        else
-            return move_err_();
-    }
+template<typename Base, Special = Special::trivial>
+struct CopyAssignLayer : Base
+{
+    using Base::Base;
+};
 
-    template<typename Fn, typename F = std::invoke_result_t< Fn, E > >
-    constexpr Result< T, F > map_err(Fn& fn)
+template<typename Base>
+struct CopyAssignLayer< Base, Special::defined > : Base
+{
+    using Base::Base;
+    CopyAssignLayer(CopyAssignLayer const&) = default;
+    CopyAssignLayer(CopyAssignLayer&&) = default;
+    constexpr CopyAssignLayer& operator=(CopyAssignLayer const& other)
     {
-        static_assert(details::is_op_v< F, Fn, T >,
-            "Function is not of signature Fn(E) -> F");
-
-        if (is_ok())
-            return move_ok_();
-        else
-            return Err( fn(move_e_()) );
+        this->assign_from_(other);
+        return *this;
     }
+    CopyAssignLayer& operator=(CopyAssignLayer&&) = default;
+};
 
-    template<typename Res>
-    constexpr Res and_(Res&& res)
-    {
-        static_assert(details::is_result_v< Res >,
-            "Argument is not a Result type");
-        static_assert(details::is_equiv_v< ErrE, typename Res::ErrE >,
-            "Err type of argument and object is not equivalent");
+template<typename Base>
+struct CopyAssignLayer< Base, Special::deleted > : Base
+{
+    using Base::Base;
+    CopyAssignLayer(CopyAssignLayer const&) = default;
+    CopyAssignLayer(CopyAssignLayer&&) = default;
+    CopyAssignLayer& operator=(CopyAssignLayer const&) = delete;
+    CopyAssignLayer& operator=(CopyAssignLayer&&) = default;
+};
 
-        if (is_ok())
-            return std::forward< Res >(res);
-        else
-            return move_err_();
-    }
+template<typename Base, Special = Special::trivial>
+struct MoveAssignLayer : Base
+{
+    using Base::Base;
+};
 
-    template<typename Fn, typename Res = std::invoke_result_t< Fn, T > >
-    constexpr Res and_then(Fn& fn)
+template<typename Base>
+struct MoveAssignLayer< Base, Special::defined > : Base
+{
+    using Base::Base;
+    MoveAssignLayer(MoveAssignLayer const&) = default;
+    MoveAssignLayer(MoveAssignLayer&&) = default;
+    MoveAssignLayer& operator=(MoveAssignLayer const&) = default;
+    constexpr MoveAssignLayer& operator=(MoveAssignLayer&& other) noexcept(
+        std::is_nothrow_move_constructible_v< typename Base::ST > &&
+        std::is_nothrow_move_assignable_v< typename Base::ST > &&
+        std::is_nothrow_move_constructible_v< typename Base::SE > &&
+        std::is_nothrow_move_assignable_v< typename Base::SE >)
     {
-        static_assert(details::is_op_v< Res, Fn, T >,
-            "Function is not of signature Fn(T) -> Res<U, E>");
-        static_assert(details::is_result_v< Res >,
-            "Return value is not a Result type");
-        static_assert(details::is_equiv_v< ErrE, typename Res::ErrE >,
-            "Err type of return value and object is not equivalent");
-
-        if (is_ok())
-            return fn(move_t_());
-        else
-            return move_err_();
+        this->assign_from_(std::move(other));
+        return *this;
     }
+};
 
-    template<typename Res>
-    constexpr Res or_(Res&& res)
-    {
-        static_assert(details::is_result_v< Res >,
-            "Argument is not a Result type");
-        static_assert(details::is_equiv_v< OkT, typename Res::OkT >,
-            "Ok type of argument and object is not equivalent");
+template<typename Base>
+struct MoveAssignLayer< Base, Special::deleted > : Base
+{
+    using Base::Base;
+    MoveAssignLayer(MoveAssignLayer const&) = default;
+    MoveAssignLayer(MoveAssignLayer&&) = default;
+    MoveAssignLayer& operator=(MoveAssignLayer const&) = default;
+    MoveAssignLayer& operator=(MoveAssignLayer&&) = delete;
+};
 
-        if (is_ok())
-            return move_ok_();
-        else
-            return std::forward< Res >(res);
-    }
+#undef RESULT_DEFAULT_SPECIALS_
 
-    template<typename Fn, typename Res = std::invoke_result_t< Fn, E > >
-    constexpr Res or_else(Fn& fn)
-    {
-        static_assert(details::is_op_v< Res, Fn, E >,
-            "Function is not of signature Fn(E) -> Res<T, F>");
-        static_assert(details::is_result_v< Res >,
-            "Return value is not a Result type");
-        static_assert(details::is_equiv_v< OkT, typename Res::OkT >,
-            "Ok type of return value and object is not equivalent");
+template<typename T, typename E, typename ST = stored_t< T >, typename SE = stored_t< E > >
+constexpr bool all_trivial_v =
+    dtor_v< ST, SE > == Special::trivial && copy_ctor_v< ST, SE > == Special::trivial &&
+    move_ctor_v< ST, SE > == Special::trivial && copy_assign_v< ST, SE > == Special::trivial &&
+    move_assign_v< ST, SE > == Special::trivial;
 
-        if (is_ok())
-            return move_ok_();
-        else
-            return fn(move_e_());
-    }
+template<typename T, typename E, typename ST = stored_t< T >, typename SE = stored_t< E > >
+using LayeredStorage = 
+    MoveAssignLayer< 
+    CopyAssignLayer< 
+    MoveCtorLayer< 
+    CopyCtorLayer< 
+    DtorLayer< TaggedBase< T, E >, dtor_v< ST, SE > >,
+    copy_ctor_v< ST, SE > >,
+    move_ctor_v< ST, SE > >,
+    copy_assign_v< ST, SE > >,
+    move_assign_v< ST, SE > >;
 
-    constexpr bool operator<(ResT const & other) { return rel_op_(other, std::less<>()); }
-    constexpr bool operator>(ResT const & other) { return rel_op_(other, std::greater<>()); }
-    constexpr bool operator<=(ResT const & other) { return rel_op_(other, std::less_equal<>()); }
-    constexpr bool operator>=(ResT const & other) { return rel_op_(other, std::greater_equal<>()); }
-    constexpr bool operator==(ResT const & other) { return rel_op_(other, std::equal_to<>()); }
+// Trivial payloads use TaggedBase directly. GCC does not build a returned
+// object in registers when its members live in a base class, so even the
+// empty trivial layers would send every small Result through the stack.
+template<typename T, typename E>
+using TaggedStorage = std::conditional_t< all_trivial_v< T, E >,
+    TaggedBase< T, E >,
+    LayeredStorage< T, E >
+>;
 
-private:
-    template<typename Op>
-    constexpr bool rel_op_(ResT const& other, Op & op)
-    {
-        if (is_ok() && other.is_ok())
-            return op(get_t_(), other.get_t_());
-        else if (is_err() && other.is_err())
-            return op(get_e_(), other.get_e_());
-        else
-            return is_ok();
-    }
+template<typename O>
+constexpr bool is_niche_filler_v = 
+    std::is_empty_v< O > &&
+    std::is_trivially_default_constructible_v< O > &&
+    std::is_trivially_copyable_v< O >;
 
-    constexpr OkT & get_ok_() { return std::get< OkT >(variant_); }
-    constexpr ErrE & get_err_() { return std::get< ErrE >(variant_); }
+// Storage for a Result where one side has a niche and the other side is
+// an empty type. The niche side is always alive and holds the spare value
+// while the empty side is active, so the discriminant costs no space.
+template<typename T, typename E>
+class NicheStorage
+{
+    static constexpr bool niche_ok_ = 
+        niche_traits< stored_t< T > >::has_niche && is_niche_filler_v< stored_t< E > >;
 
-    constexpr OkT move_ok_() { return std::get< OkT >(std::move(variant_)); }
-    constexpr ErrE move_err_() { return std::get< ErrE >(std::move(variant_)); }
+    using ST = stored_t< T >;
+    using SE = stored_t< E >;
+    using N = std::conditional_t< niche_ok_, ST, SE >;
+    using O = std::conditional_t< niche_ok_, SE, ST >;
 
-    constexpr T & get_t_() { return get_ok_().t_; }
-    constexpr E & get_e_() { return get_err_().e_; }
+    N n_;
+    RESULT_NO_UNIQUE_ADDRESS O o_;
 
-    constexpr T move_t_() { return std::move(get_t_()); }
-    constexpr E move_e_() { return std::move(get_e_()); }
+    template<typename... Args>
+    constexpr NicheStorage(std::true_type, Args&&... args)
+        : n_(std::forward< Args >(args)...), o_() {}
 
-    template<typename U, typename F>
-    friend class Result;
-};
+    template<typename... Args>
+    constexpr NicheStorage(std::false_type, Args&&... args)
+        : n_(niche_traits< N >::niche()), o_(std::forward< Args >(args)...) {}
 
-#define TRY(...) \
-    ({ \
-        auto res = (__VA_ARGS__); \
-        if (res.is_err()) { \
-            return res.unwrap_err(); \
+public:
+    template<typename... Args>
+    constexpr NicheStorage(OkTag, Args&&... args)
+        : NicheStorage(std::bool_constant< niche_ok_ >{}, std::forward< Args >(args)...) {}
+
+    template<typename... Args>
+    constexpr NicheStorage(ErrTag, Args&&... args)
+        : NicheStorage(std::bool_constant< !niche_ok_ >{}, std::forward< Args >(args)...) {}
+
+    constexpr bool has_ok() const { return niche_traits< N >::is_niche(n_) != niche_ok_; }
+
+    constexpr T & t() { return Stored< T >::get(ok_slot_(*this)); }
+    constexpr T const& t() const { return Stored< T >::get(ok_slot_(*this)); }
+    constexpr E & e() { return Stored< E >::get(err_slot_(*this)); }
+    constexpr E const& e() const { return Stored< E >::get(err_slot_(*this)); }
+
+    template<typename... Args>
+    constexpr T & emplace_t(Args&&... args)
+    {
+        emplace_(std::bool_constant< niche_ok_ >{}, std::forward< Args >(args)...);
+        return t();
+    }
+
+    template<typename... Args>
+    constexpr E & emplace_e(Args&&... args)
+    {
+        emplace_(std::bool_constant< !niche_ok_ >{}, std::forward< Args >(args)...);
+        return e();
+    }
+
+private:
+    template<typename... Args>
+    constexpr void emplace_(std::true_type, Args&&... args)
+    {
+        n_ = N(std::forward< Args >(args)...);
+    }
+
+    template<typename... Args>
+    constexpr void emplace_(std::false_type, Args&&... args)
+    {
+        details::construct_at(&o_, std::forward< Args >(args)...);
+        n_ = niche_traits< N >::niche();
+    }
+
+    template<typename Self>
+    static constexpr auto & ok_slot_(Self & self)
+    {
+        if constexpr (niche_ok_)
+            return self.n_;
+        else
+            return self.o_;
+    }
+
+    template<typename Self>
+    static constexpr auto & err_slot_(Self & self)
+    {
+        if constexpr (niche_ok_)
+            return self.o_;
+        else
+            return self.n_;
+    }
+};
+
+template<typename T, typename E>
+constexpr bool use_niche_v = 
+    (niche_traits< stored_t< T > >::has_niche && is_niche_filler_v< stored_t< E > >) ||
+    (niche_traits< stored_t< E > >::has_niche && is_niche_filler_v< stored_t< T > >);
+
+template<typename T, typename E>
+using storage_t = std::conditional_t< use_niche_v< T, E >,
+    NicheStorage< T, E >,
+    TaggedStorage< T, E >
+>;
+
+#if defined(RESULT_TRACE)
+// Error payload stored together with its return trace
+template<typename E>
+struct Traced
+{
+    stored_t< E > e;
+    ReturnTrace trace;
+
+    template<typename... Args, typename = std::enable_if_t<
+        std::is_constructible_v< stored_t< E >, Args&&... > > >
+    constexpr Traced(Args&&... args) : e(std::forward< Args >(args)...) {}
+
+    template<typename... Args>
+    constexpr Traced(TraceTag, ReturnTrace const& t, Args&&... args)
+        : e(std::forward< Args >(args)...), trace(t) {}
+};
+
+template<typename E>
+using err_storage_t = Traced< E >;
+#else
+template<typename E>
+using err_storage_t = E;
+#endif
+
+// How uses-allocator construction builds an A from args and allocator a,
+// as std::make_obj_using_allocator does: without a, with a leading
+// (std::allocator_arg, a) or with a trailing a
+struct AllocNone {};
+struct AllocLeading {};
+struct AllocTrailing {};
+
+template<typename A, typename Alloc, typename... Args>
+struct uses_alloc
+{
+    static constexpr bool leading = std::is_constructible_v< A, std::allocator_arg_t, Alloc const&, Args... >;
+    static constexpr bool trailing = std::is_constructible_v< A, Args..., Alloc const& >;
+    static_assert(!std::uses_allocator_v< A, Alloc > || leading || trailing,
+        "Payload uses the allocator but cannot be constructed with it from these arguments");
+
+    using type = std::conditional_t< !std::uses_allocator_v< A, Alloc >, AllocNone,
+        std::conditional_t< leading, AllocLeading, AllocTrailing > >;
+};
+
+template<typename A, typename Alloc, typename... Args>
+using uses_alloc_t = typename uses_alloc< A, Alloc, Args... >::type;
+
+} /* namespace details */
+
+
+template<typename T>
+struct niche_traits< details::Ref< T > >
+{
+    static constexpr bool has_niche = true;
+    static constexpr details::Ref< T > niche() { return details::Ref< T >(nullptr); }
+    static constexpr bool is_niche(details::Ref< T > const& r) { return r.is_null(); }
+};
+
+
+// Tags selecting the alternative built in place by Result's constructors
+struct in_place_ok_t { explicit in_place_ok_t() = default; };
+struct in_place_err_t { explicit in_place_err_t() = default; };
+
+inline constexpr in_place_ok_t in_place_ok{};
+inline constexpr in_place_err_t in_place_err{};
+
+
+template<typename T>
+constexpr auto Ok(T&& t)
+{
+    using CleanT = std::decay_t< T >;
+    return details::Ok< CleanT >(std::forward< T >(t));
+}
+
+#if defined(RESULT_INSTRUMENT) || defined(RESULT_TRACE)
+// Records its call site; see result_instrument.hpp and RESULT_TRACE
+template<typename E>
+constexpr auto Err(E&& e, details::SourceLocation loc = details::SourceLocation::current())
+{
+    using CleanE = std::decay_t< E >;
+#if defined(RESULT_INSTRUMENT)
+    RESULT_INSTRUMENT_(instrument_err, loc);
+#endif
+#if defined(RESULT_TRACE)
+    return details::Err< CleanE >(details::ReturnTrace(loc), std::forward< E >(e));
+#else
+    return details::Err< CleanE >(std::forward< E >(e));
+#endif
+}
+#else
+template<typename E>
+constexpr auto Err(E&& e)
+{
+    using CleanE = std::decay_t< E >;
+    return details::Err< CleanE >(std::forward< E >(e));
+}
+#endif
+
+// Payload-less alternatives, for Result< void, E > and Result< T, void >
+constexpr auto Ok() { return details::Ok< details::Unit >(details::Unit{}); }
+#if defined(RESULT_INSTRUMENT) || defined(RESULT_TRACE)
+constexpr auto Err(details::SourceLocation loc = details::SourceLocation::current())
+{
+#if defined(RESULT_INSTRUMENT)
+    RESULT_INSTRUMENT_(instrument_err, loc);
+#endif
+#if defined(RESULT_TRACE)
+    return details::Err< details::Unit >(details::ReturnTrace(loc), details::Unit{});
+#else
+    return details::Err< details::Unit >(details::Unit{});
+#endif
+}
+#else
+constexpr auto Err() { return details::Err< details::Unit >(details::Unit{}); }
+#endif
+
+
+// Customization point for Result::context and with_context, saying how an
+// error of type E takes on a context message. A specialization provides:
+//
+//   static constexpr bool enabled = true;
+//   static E attach(E&& e, std::string_view literal, details::SourceLocation loc);
+//   template<typename Msg>
+//   static E attach_formatted(E&& e, Msg&& msg, details::SourceLocation loc);
+//
+// attach gets a message that outlives the error, such as a string literal,
+// and should not copy it; attach_formatted gets whatever the with_context
+// callback returned.
+template<typename E>
+struct error_context
+{
+    static constexpr bool enabled = false;
+};
+
+// std::string errors become "context: error"
+template<>
+struct error_context< std::string >
+{
+    static constexpr bool enabled = true;
+
+    static std::string attach(std::string&& e, std::string_view literal, details::SourceLocation)
+    {
+        return std::string(literal).append(": ").append(e);
+    }
+
+    template<typename Msg>
+    static std::string attach_formatted(std::string&& e, Msg&& msg, details::SourceLocation loc)
+    {
+        return attach(std::move(e), std::string_view(msg), loc);
+    }
+};
+
+
+template<typename T, typename E>
+class Result : details::ResultBase
+{
+    using ResT = Result< T, E >;
+    using ValT = details::value_t< T >;
+    using ValE = details::value_t< E >;
+    using OkT  = details::Ok< ValT >;
+    using ErrE = details::Err< ValE >;
+
+    details::storage_t< ValT, details::err_storage_t< ValE > > storage_;
+
+public:
+    using value_type = T;
+    using error_type = E;
+
+    template<typename U>
+    constexpr Result(details::Ok< U > ok) : storage_(details::OkTag{}, std::forward< U >(ok.t_)) {}
+
+    template<typename F>
+#if defined(RESULT_TRACE)
+    constexpr Result(details::Err< F > err)
+        : storage_(details::ErrTag{}, details::TraceTag{}, err.trace_, std::forward< F >(err.e_)) {}
+#else
+    constexpr Result(details::Err< F > err) : storage_(details::ErrTag{}, std::forward< F >(err.e_)) {}
+#endif
+
+    // Build the payload directly in the Result's storage, without moving
+    // through an Ok/Err wrapper. Works for non-movable payloads too.
+    template<typename... Args>
+    constexpr explicit Result(in_place_ok_t, Args&&... args) 
+        : storage_(details::OkTag{}, std::forward< Args >(args)...) {}
+
+    template<typename... Args>
+    constexpr explicit Result(in_place_err_t, Args&&... args) 
+        : storage_(details::ErrTag{}, std::forward< Args >(args)...) {}
+
+    // Uses-allocator construction: the payload is built with alloc when it
+    // takes an allocator, so an arena-backed container or resource keeps
+    // Ok and Err payloads in the arena too
+    template<typename Alloc, typename... Args>
+    constexpr explicit Result(std::allocator_arg_t, Alloc const& alloc, in_place_ok_t, Args&&... args)
+        : Result(details::uses_alloc_t< ValT, Alloc, Args&&... >{}, details::OkTag{}, alloc,
+            std::forward< Args >(args)...) {}
+
+    template<typename Alloc, typename... Args>
+    constexpr explicit Result(std::allocator_arg_t, Alloc const& alloc, in_place_err_t, Args&&... args)
+        : Result(details::uses_alloc_t< ValE, Alloc, Args&&... >{}, details::ErrTag{}, alloc,
+            std::forward< Args >(args)...) {}
+
+    template<typename Alloc, typename U>
+    constexpr Result(std::allocator_arg_t, Alloc const& alloc, details::Ok< U > ok)
+        : Result(std::allocator_arg, alloc, in_place_ok, std::forward< U >(ok.t_)) {}
+
+    template<typename Alloc, typename F>
+#if defined(RESULT_TRACE)
+    constexpr Result(std::allocator_arg_t, Alloc const& alloc, details::Err< F > err)
+        : Result(alloc_err_(err.trace_, alloc, std::forward< F >(err.e_))) {}
+#else
+    constexpr Result(std::allocator_arg_t, Alloc const& alloc, details::Err< F > err)
+        : Result(std::allocator_arg, alloc, in_place_err, std::forward< F >(err.e_)) {}
+#endif
+
+    template<typename Alloc>
+    constexpr Result(std::allocator_arg_t, Alloc const& alloc, Result const& other)
+        : Result(with_alloc_(alloc, other)) {}
+
+    template<typename Alloc>
+    constexpr Result(std::allocator_arg_t, Alloc const& alloc, Result&& other)
+        : Result(with_alloc_(alloc, std::move(other))) {}
+
+    // Make movable
+    constexpr Result(Result&&) = default;
+    constexpr Result& operator=(Result&&) = default;
+
+    // Copyable when T and E are, and trivially so when both are trivial
+    constexpr Result(Result const&) = default;
+    constexpr Result& operator=(Result const&) = default;
+
+    // Make non-default constructable
+    Result() = delete;
+
+    // API
+    constexpr bool is_ok() const { return storage_.has_ok(); }
+    constexpr bool is_err() const { return !storage_.has_ok(); }
+
+    // Destroy the current payload and construct a new one in its place. A
+    // constructor that may throw needs a nothrow movable payload to back up
+    // the old value, so the Result is never left without one.
+    template<typename... Args>
+    constexpr details::like_t< ResT&, T > emplace_ok(Args&&... args)
+    {
+        return static_cast< details::like_t< ResT&, T > >(
+            storage_.emplace_t(std::forward< Args >(args)...));
+    }
+
+    template<typename... Args>
+    constexpr details::like_t< ResT&, E > emplace_err(Args&&... args)
+    {
+#if defined(RESULT_TRACE)
+        storage_.emplace_e(std::forward< Args >(args)...);
+        return static_cast< details::like_t< ResT&, E > >(get_e_());
+#else
+        return static_cast< details::like_t< ResT&, E > >(
+            storage_.emplace_e(std::forward< Args >(args)...));
+#endif
+    }
+
+    // Borrowing views; the Result keeps its payload
+    constexpr Result< details::like_t< ResT const&, T >, details::like_t< ResT const&, E > > 
+    as_ref() const { return borrow_(*this); }
+
+    constexpr Result< details::like_t< ResT&, T >, details::like_t< ResT&, E > > 
+    as_mut() { return borrow_(*this); }
+
+    constexpr std::remove_reference_t< ValT > * value_ptr() 
+    { 
+        return is_ok() ? std::addressof(get_t_()) : nullptr; 
+    }
+
+    constexpr std::remove_reference_t< ValT > const * value_ptr() const 
+    { 
+        return is_ok() ? std::addressof(get_t_()) : nullptr; 
+    }
+
+    constexpr std::remove_reference_t< ValE > * error_ptr() 
+    { 
+        return is_err() ? std::addressof(get_e_()) : nullptr; 
+    }
+
+    constexpr std::remove_reference_t< ValE > const * error_ptr() const 
+    { 
+        return is_err() ? std::addressof(get_e_()) : nullptr; 
+    }
+
+    constexpr std::optional< ValT > ok() const& { return ok_(*this); }
+    constexpr std::optional< ValT > ok() && { return ok_(std::move(*this)); }
+
+    constexpr std::optional< ValE > err() const& { return err_(*this); }
+    constexpr std::optional< ValE > err() && { return err_(std::move(*this)); }
+
+    // unwrap and expect return references into lvalue Results and move the
+    // payload out of rvalue Results
+    constexpr details::like_t< ResT&, T > unwrap() & noexcept(details::panic_noexcept)
+    {
+        return get_t_or_panic_< details::like_t< ResT&, T > >(*this, "Result::unwrap panicked");
+    }
+
+    constexpr details::like_t< ResT const&, T > unwrap() const& noexcept(details::panic_noexcept)
+    {
+        return get_t_or_panic_< details::like_t< ResT const&, T > >(*this, "Result::unwrap panicked");
+    }
+
+    constexpr T unwrap() && noexcept(details::panic_noexcept && std::is_nothrow_move_constructible_v< ValT >)
+    {
+        return get_t_or_panic_< T >(std::move(*this), "Result::unwrap panicked");
+    }
+
+    constexpr details::like_t< ResT&, E > unwrap_err() & noexcept(details::panic_noexcept)
+    {
+        return get_e_or_panic_< details::like_t< ResT&, E > >(*this, "Result::unwrap_err panicked");
+    }
+
+    constexpr details::like_t< ResT const&, E > unwrap_err() const& noexcept(details::panic_noexcept)
+    {
+        return get_e_or_panic_< details::like_t< ResT const&, E > >(*this, "Result::unwrap_err panicked");
+    }
+
+    constexpr E unwrap_err() && noexcept(details::panic_noexcept && std::is_nothrow_move_constructible_v< ValE >)
+    {
+        return get_e_or_panic_< E >(std::move(*this), "Result::unwrap_err panicked");
+    }
+
+    template<typename U>
+    constexpr T unwrap_or(U&& default_value) const& 
+    { 
+        return unwrap_or_(*this, std::forward< U >(default_value)); 
+    }
+
+    template<typename U>
+    constexpr T unwrap_or(U&& default_value) && 
+    { 
+        return unwrap_or_(std::move(*this), std::forward< U >(default_value)); 
+    }
+
+    constexpr T unwrap_or_default() const&
+    {
+        if (is_ok())
+            return static_cast< T >(fwd_t_(*this));
+        else
+            return T();
+    }
+
+    constexpr T unwrap_or_default() &&
+    {
+        if (is_ok())
+            return static_cast< T >(fwd_t_(std::move(*this)));
+        else
+            return T();
+    }
+
+    constexpr details::like_t< ResT&, T > expect(std::string_view msg) & noexcept(details::panic_noexcept)
+    {
+        return get_t_or_panic_< details::like_t< ResT&, T > >(*this, msg);
+    }
+
+    constexpr details::like_t< ResT const&, T > expect(std::string_view msg) const& noexcept(details::panic_noexcept)
+    {
+        return get_t_or_panic_< details::like_t< ResT const&, T > >(*this, msg);
+    }
+
+    constexpr T expect(std::string_view msg) && noexcept(
+        details::panic_noexcept && std::is_nothrow_move_constructible_v< ValT >)
+    {
+        return get_t_or_panic_< T >(std::move(*this), msg);
+    }
+
+    constexpr details::like_t< ResT&, E > expect_err(std::string_view msg) & noexcept(details::panic_noexcept)
+    {
+        return get_e_or_panic_< details::like_t< ResT&, E > >(*this, msg);
+    }
+
+    constexpr details::like_t< ResT const&, E > expect_err(std::string_view msg) const& noexcept(details::panic_noexcept)
+    {
+        return get_e_or_panic_< details::like_t< ResT const&, E > >(*this, msg);
+    }
+
+    constexpr E expect_err(std::string_view msg) && noexcept(
+        details::panic_noexcept && std::is_nothrow_move_constructible_v< ValE >)
+    {
+        return get_e_or_panic_< E >(std::move(*this), msg);
+    }
+
+    // Accessors for code that has already tested the alternative; see
+    // RESULT_CHECK_UNCHECKED
+    constexpr details::like_t< ResT&, T > unwrap_unchecked(
+        details::SourceLocation loc = details::SourceLocation::current()) & noexcept
+    {
+        assume_ok_("Result::unwrap_unchecked on an Err", loc);
+        return static_cast< details::like_t< ResT&, T > >(fwd_t_(*this));
+    }
+
+    constexpr details::like_t< ResT const&, T > unwrap_unchecked(
+        details::SourceLocation loc = details::SourceLocation::current()) const& noexcept
+    {
+        assume_ok_("Result::unwrap_unchecked on an Err", loc);
+        return static_cast< details::like_t< ResT const&, T > >(fwd_t_(*this));
+    }
+
+    constexpr T unwrap_unchecked(
+        details::SourceLocation loc = details::SourceLocation::current()) && noexcept(std::is_nothrow_move_constructible_v< ValT >)
+    {
+        assume_ok_("Result::unwrap_unchecked on an Err", loc);
+        return static_cast< T >(fwd_t_(std::move(*this)));
+    }
+
+    constexpr details::like_t< ResT&, E > unwrap_err_unchecked(
+        details::SourceLocation loc = details::SourceLocation::current()) & noexcept
+    {
+        assume_err_("Result::unwrap_err_unchecked on an Ok", loc);
+        return static_cast< details::like_t< ResT&, E > >(fwd_e_(*this));
+    }
+
+    constexpr details::like_t< ResT const&, E > unwrap_err_unchecked(
+        details::SourceLocation loc = details::SourceLocation::current()) const& noexcept
+    {
+        assume_err_("Result::unwrap_err_unchecked on an Ok", loc);
+        return static_cast< details::like_t< ResT const&, E > >(fwd_e_(*this));
+    }
+
+    constexpr E unwrap_err_unchecked(
+        details::SourceLocation loc = details::SourceLocation::current()) && noexcept(std::is_nothrow_move_constructible_v< ValE >)
+    {
+        assume_err_("Result::unwrap_err_unchecked on an Ok", loc);
+        return static_cast< E >(fwd_e_(std::move(*this)));
+    }
+
+    // Operators cannot take the caller's location, so checked builds report
+    // the operator itself
+    constexpr details::like_t< ResT&, T > operator*() & noexcept
+    {
+        assume_ok_("Result::operator* on an Err", details::SourceLocation::current());
+        return static_cast< details::like_t< ResT&, T > >(fwd_t_(*this));
+    }
+
+    constexpr details::like_t< ResT const&, T > operator*() const& noexcept
+    {
+        assume_ok_("Result::operator* on an Err", details::SourceLocation::current());
+        return static_cast< details::like_t< ResT const&, T > >(fwd_t_(*this));
+    }
+
+    constexpr T operator*() && noexcept(std::is_nothrow_move_constructible_v< ValT >)
+    {
+        assume_ok_("Result::operator* on an Err", details::SourceLocation::current());
+        return static_cast< T >(fwd_t_(std::move(*this)));
+    }
+
+    constexpr std::remove_reference_t< ValT > * operator->() noexcept
+    {
+        assume_ok_("Result::operator-> on an Err", details::SourceLocation::current());
+        return std::addressof(get_t_());
+    }
+
+    constexpr std::remove_reference_t< ValT > const * operator->() const noexcept
+    {
+        assume_ok_("Result::operator-> on an Err", details::SourceLocation::current());
+        return std::addressof(get_t_());
+    }
+
+#if defined(RESULT_TRACE)
+    // Origin and propagation hops of the Err
+    constexpr details::ReturnTrace const& return_trace(
+        details::SourceLocation loc = details::SourceLocation::current()) const noexcept
+    {
+        assume_err_("Result::return_trace on an Ok", loc);
+        return trace_();
+    }
+#endif
+
+    template<typename Fn>
+    constexpr T unwrap_or_else(Fn&& fn) & { return unwrap_or_else_(*this, std::forward< Fn >(fn)); }
+    template<typename Fn>
+    constexpr T unwrap_or_else(Fn&& fn) const& { return unwrap_or_else_(*this, std::forward< Fn >(fn)); }
+    template<typename Fn>
+    constexpr T unwrap_or_else(Fn&& fn) && { return unwrap_or_else_(std::move(*this), std::forward< Fn >(fn)); }
+
+    // Combinators copy the untouched side out of lvalues and move it out of
+    // rvalues, so chains on temporaries never copy a payload.
+    template<typename Fn>
+    constexpr auto map(Fn&& fn) & { return map_(*this, std::forward< Fn >(fn)); }
+    template<typename Fn>
+    constexpr auto map(Fn&& fn) const& { return map_(*this, std::forward< Fn >(fn)); }
+    template<typename Fn>
+    constexpr auto map(Fn&& fn) && { return map_(std::move(*this), std::forward< Fn >(fn)); }
+
+    template<typename Fn>
+    constexpr auto map_err(Fn&& fn) & { return map_err_(*this, std::forward< Fn >(fn)); }
+    template<typename Fn>
+    constexpr auto map_err(Fn&& fn) const& { return map_err_(*this, std::forward< Fn >(fn)); }
+    template<typename Fn>
+    constexpr auto map_err(Fn&& fn) && { return map_err_(std::move(*this), std::forward< Fn >(fn)); }
+
+    template<typename Res>
+    constexpr auto and_(Res&& res) & { return and_impl_(*this, std::forward< Res >(res)); }
+    template<typename Res>
+    constexpr auto and_(Res&& res) const& { return and_impl_(*this, std::forward< Res >(res)); }
+    template<typename Res>
+    constexpr auto and_(Res&& res) && { return and_impl_(std::move(*this), std::forward< Res >(res)); }
+
+    template<typename Fn>
+    constexpr auto and_then(Fn&& fn) & { return and_then_(*this, std::forward< Fn >(fn)); }
+    template<typename Fn>
+    constexpr auto and_then(Fn&& fn) const& { return and_then_(*this, std::forward< Fn >(fn)); }
+    template<typename Fn>
+    constexpr auto and_then(Fn&& fn) && { return and_then_(std::move(*this), std::forward< Fn >(fn)); }
+
+    template<typename Res>
+    constexpr auto or_(Res&& res) & { return or_impl_(*this, std::forward< Res >(res)); }
+    template<typename Res>
+    constexpr auto or_(Res&& res) const& { return or_impl_(*this, std::forward< Res >(res)); }
+    template<typename Res>
+    constexpr auto or_(Res&& res) && { return or_impl_(std::move(*this), std::forward< Res >(res)); }
+
+    template<typename Fn>
+    constexpr auto or_else(Fn&& fn) & { return or_else_(*this, std::forward< Fn >(fn)); }
+    template<typename Fn>
+    constexpr auto or_else(Fn&& fn) const& { return or_else_(*this, std::forward< Fn >(fn)); }
+    template<typename Fn>
+    constexpr auto or_else(Fn&& fn) && { return or_else_(std::move(*this), std::forward< Fn >(fn)); }
+
+    // Start of a fused pipeline, evaluated in one pass; needs result_lazy.hpp
+    template<typename L = LazyResult< T, E > >
+    constexpr L lazy() && { return L(std::move(*this)); }
+
+    // Context for the Err side, built only when the Result is an Err; see
+    // error_context. msg must outlive the error, as a string literal does.
+    constexpr ResT context(std::string_view msg,
+        details::SourceLocation loc = details::SourceLocation::current()) const&
+    {
+        return context_(*this, [&](E&& e) { return error_context< E >::attach(std::move(e), msg, loc); });
+    }
+
+    constexpr ResT context(std::string_view msg,
+        details::SourceLocation loc = details::SourceLocation::current()) &&
+    {
+        return context_(std::move(*this), [&](E&& e) { return error_context< E >::attach(std::move(e), msg, loc); });
+    }
+
+    // As context, with the message produced by fn() on the error path only
+    template<typename Fn>
+    constexpr ResT with_context(Fn&& fn,
+        details::SourceLocation loc = details::SourceLocation::current()) const&
+    {
+        return context_(*this, [&](E&& e)
+        {
+            return error_context< E >::attach_formatted(std::move(e), details::invoke(std::forward< Fn >(fn)), loc);
+        });
+    }
+
+    template<typename Fn>
+    constexpr ResT with_context(Fn&& fn,
+        details::SourceLocation loc = details::SourceLocation::current()) &&
+    {
+        return context_(std::move(*this), [&](E&& e)
+        {
+            return error_context< E >::attach_formatted(std::move(e), details::invoke(std::forward< Fn >(fn)), loc);
+        });
+    }
+
+    // Oks compare by value and Errs by error, and every Ok orders before
+    // every Err. Each comparison tests the discriminants once.
+    friend constexpr bool operator==(ResT const& a, ResT const& b)
+    {
+        if (a.is_ok() != b.is_ok())
+            return false;
+        return a.is_ok() ? bool(a.get_t_() == b.get_t_()) : bool(a.get_e_() == b.get_e_());
+    }
+
+    friend constexpr bool operator!=(ResT const& a, ResT const& b) { return !(a == b); }
+
+    friend constexpr bool operator<(ResT const& a, ResT const& b)
+    {
+        if (a.is_ok() != b.is_ok())
+            return a.is_ok();
+        return a.is_ok() ? bool(a.get_t_() < b.get_t_()) : bool(a.get_e_() < b.get_e_());
+    }
+
+    friend constexpr bool operator>(ResT const& a, ResT const& b) { return b < a; }
+    friend constexpr bool operator<=(ResT const& a, ResT const& b) { return !(b < a); }
+    friend constexpr bool operator>=(ResT const& a, ResT const& b) { return !(a < b); }
+
+#if defined(__cpp_lib_three_way_comparison)
+    friend constexpr auto operator<=>(ResT const& a, ResT const& b)
+        requires std::three_way_comparable< ValT > && std::three_way_comparable< ValE >
+    {
+        using Cat = std::common_comparison_category_t<
+            std::compare_three_way_result_t< ValT >, std::compare_three_way_result_t< ValE > >;
+        if (a.is_ok() != b.is_ok())
+            return a.is_ok() ? Cat(std::strong_ordering::less) : Cat(std::strong_ordering::greater);
+        return a.is_ok() ? Cat(a.get_t_() <=> b.get_t_()) : Cat(a.get_e_() <=> b.get_e_());
+    }
+#endif
+
+    // Against bare Ok(x) / Err(e), without building a Result
+    template<typename U>
+    friend constexpr bool operator==(ResT const& a, details::Ok< U > const& ok)
+    {
+        return a.is_ok() && bool(a.get_t_() == ok.t_);
+    }
+
+    template<typename F>
+    friend constexpr bool operator==(ResT const& a, details::Err< F > const& err)
+    {
+        return a.is_err() && bool(a.get_e_() == err.e_);
+    }
+
+    template<typename U>
+    friend constexpr bool operator==(details::Ok< U > const& ok, ResT const& a) { return a == ok; }
+    template<typename F>
+    friend constexpr bool operator==(details::Err< F > const& err, ResT const& a) { return a == err; }
+    template<typename U>
+    friend constexpr bool operator!=(ResT const& a, details::Ok< U > const& ok) { return !(a == ok); }
+    template<typename F>
+    friend constexpr bool operator!=(ResT const& a, details::Err< F > const& err) { return !(a == err); }
+    template<typename U>
+    friend constexpr bool operator!=(details::Ok< U > const& ok, ResT const& a) { return !(a == ok); }
+    template<typename F>
+    friend constexpr bool operator!=(details::Err< F > const& err, ResT const& a) { return !(a == err); }
+
+private:
+
+    constexpr OkT move_ok_() { return OkT( static_cast< ValT&& >(get_t_()) ); }
+#if defined(RESULT_TRACE)
+    constexpr ErrE move_err_() { return ErrE( trace_(), static_cast< ValE&& >(get_e_()) ); }
+    constexpr ErrE copy_err_() const { return ErrE( trace_(), get_e_() ); }
+#else
+    constexpr ErrE move_err_() { return ErrE( static_cast< ValE&& >(get_e_()) ); }
+    constexpr ErrE copy_err_() const { return ErrE( get_e_() ); }
+#endif
+
+    constexpr ValT & get_t_() { return storage_.t(); }
+    constexpr ValT const& get_t_() const { return storage_.t(); }
+#if defined(RESULT_TRACE)
+    constexpr ValE & get_e_() { return details::Stored< ValE >::get(storage_.e().e); }
+    constexpr ValE const& get_e_() const { return details::Stored< ValE >::get(storage_.e().e); }
+
+    constexpr details::ReturnTrace & trace_() { return storage_.e().trace; }
+    constexpr details::ReturnTrace const& trace_() const { return storage_.e().trace; }
+
+    template<typename... Args>
+    constexpr Result(details::TraceTag, details::ReturnTrace const& trace, Args&&... args)
+        : storage_(details::ErrTag{}, details::TraceTag{}, trace, std::forward< Args >(args)...) {}
+#else
+    constexpr ValE & get_e_() { return storage_.e(); }
+    constexpr ValE const& get_e_() const { return storage_.e(); }
+#endif
+
+    template<typename Tag, typename Alloc, typename... Args>
+    constexpr Result(details::AllocNone, Tag tag, Alloc const&, Args&&... args)
+        : storage_(tag, std::forward< Args >(args)...) {}
+
+    template<typename Tag, typename Alloc, typename... Args>
+    constexpr Result(details::AllocLeading, Tag tag, Alloc const& alloc, Args&&... args)
+        : storage_(tag, std::allocator_arg, alloc, std::forward< Args >(args)...) {}
+
+    template<typename Tag, typename Alloc, typename... Args>
+    constexpr Result(details::AllocTrailing, Tag tag, Alloc const& alloc, Args&&... args)
+        : storage_(tag, std::forward< Args >(args)..., alloc) {}
+
+    // Copy or move of other whose payload is rebuilt with alloc
+    template<typename Alloc, typename Self>
+    static constexpr ResT with_alloc_(Alloc const& alloc, Self&& other)
+    {
+        if (other.is_ok())
+        {
+            if constexpr (std::is_void_v< T >)
+                return ResT(in_place_ok);
+            else
+                return ResT(std::allocator_arg, alloc, in_place_ok, fwd_t_(std::forward< Self >(other)));
+        }
+        if constexpr (std::is_void_v< E >)
+            return traced_err_< ResT >(other);
+#if defined(RESULT_TRACE)
+        else
+            return alloc_err_(other.trace_(), alloc, fwd_e_(std::forward< Self >(other)));
+#else
+        else
+            return ResT(std::allocator_arg, alloc, in_place_err, fwd_e_(std::forward< Self >(other)));
+#endif
+    }
+
+#if defined(RESULT_TRACE)
+    // Error built from args with alloc, as the in_place_err allocator
+    // constructor does, that takes over trace
+    template<typename Alloc, typename... Args>
+    static constexpr ResT alloc_err_(details::ReturnTrace const& trace, Alloc const& alloc, Args&&... args)
+    {
+        using How = details::uses_alloc_t< ValE, Alloc, Args&&... >;
+        if constexpr (std::is_same_v< How, details::AllocNone >)
+            return ResT(details::TraceTag{}, trace, std::forward< Args >(args)...);
+        else if constexpr (std::is_same_v< How, details::AllocLeading >)
+            return ResT(details::TraceTag{}, trace, std::allocator_arg, alloc, std::forward< Args >(args)...);
+        else
+            return ResT(details::TraceTag{}, trace, std::forward< Args >(args)..., alloc);
+    }
+#endif
+
+    // R holding the error built from args, which takes over the return
+    // trace of src in RESULT_TRACE builds
+    template<typename R, typename... Args>
+    static constexpr R traced_err_(ResT const& src, Args&&... args)
+    {
+#if defined(RESULT_TRACE)
+        return R(details::TraceTag{}, src.trace_(), std::forward< Args >(args)...);
+#else
+        (void)src;
+        return R(in_place_err, std::forward< Args >(args)...);
+#endif
+    }
+
+    constexpr T move_t_()
+    {
+        if constexpr (!std::is_void_v< T >)
+            return static_cast< T&& >(get_t_());
+    }
+
+    constexpr E move_e_()
+    {
+        if constexpr (!std::is_void_v< E >)
+            return static_cast< E&& >(get_e_());
+    }
+
+    // Payload of self, as an lvalue for lvalue selves and moved otherwise
+    template<typename Self>
+    static constexpr details::like_t< Self, ValT > fwd_t_(Self&& self)
+    {
+        return static_cast< details::like_t< Self, ValT > >(self.storage_.t());
+    }
+
+    template<typename Self>
+    static constexpr details::like_t< Self, ValE > fwd_e_(Self&& self)
+    {
+        return static_cast< details::like_t< Self, ValE > >(self.get_e_());
+    }
+
+    // The untouched side of self, built in place into another Result type
+    template<typename R, typename Self>
+    static constexpr R ok_into_(Self&& self)
+    {
+        if constexpr (std::is_void_v< T >)
+            return R(in_place_ok);
+        else
+            return R(in_place_ok, fwd_t_(std::forward< Self >(self)));
+    }
+
+    template<typename R, typename Self>
+    static constexpr R err_into_(Self&& self)
+    {
+        if constexpr (std::is_void_v< E >)
+            return traced_err_< R >(self);
+        else
+            return traced_err_< R >(self, fwd_e_(std::forward< Self >(self)));
+    }
+
+    // Invoke fn with the payload of self, or with no arguments if it is void
+    template<typename Self, typename Fn>
+    static constexpr decltype(auto) call_with_t_(Self&& self, Fn&& fn)
+    {
+        if constexpr (std::is_void_v< T >)
+            return details::invoke(std::forward< Fn >(fn));
+        else
+            return details::invoke(std::forward< Fn >(fn), fwd_t_(std::forward< Self >(self)));
+    }
+
+    template<typename Self, typename Fn>
+    static constexpr decltype(auto) call_with_e_(Self&& self, Fn&& fn)
+    {
+        if constexpr (std::is_void_v< E >)
+            return details::invoke(std::forward< Fn >(fn));
+        else
+            return details::invoke(std::forward< Fn >(fn), fwd_e_(std::forward< Self >(self)));
+    }
+
+    constexpr void assume_ok_(char const * what, details::SourceLocation loc) const noexcept
+    {
+#if RESULT_CHECK_UNCHECKED
+        if (RESULT_UNLIKELY(!is_ok()))
+            details::unchecked_violation(what, loc);
+#else
+        (void)what;
+        (void)loc;
+        RESULT_ASSUME(is_ok());
+#endif
+    }
+
+    constexpr void assume_err_(char const * what, details::SourceLocation loc) const noexcept
+    {
+#if RESULT_CHECK_UNCHECKED
+        if (RESULT_UNLIKELY(!is_err()))
+            details::unchecked_violation(what, loc);
+#else
+        (void)what;
+        (void)loc;
+        RESULT_ASSUME(is_err());
+#endif
+    }
+
+    template<typename R, typename Self>
+    static constexpr R get_t_or_panic_(Self&& self, std::string_view msg) noexcept(
+        details::panic_noexcept &&
+        (std::is_void_v< R > || std::is_nothrow_constructible_v< R, details::like_t< Self, ValT > >))
+    {
+        if (RESULT_LIKELY(self.is_ok()))
+            return static_cast< R >(fwd_t_(std::forward< Self >(self)));
+        details::panic(msg);
+    }
+
+    template<typename R, typename Self>
+    static constexpr R get_e_or_panic_(Self&& self, std::string_view msg) noexcept(
+        details::panic_noexcept &&
+        (std::is_void_v< R > || std::is_nothrow_constructible_v< R, details::like_t< Self, ValE > >))
+    {
+        if (RESULT_LIKELY(self.is_err()))
+            return static_cast< R >(fwd_e_(std::forward< Self >(self)));
+        details::panic(msg);
+    }
+
+    template<typename Self>
+    static constexpr std::optional< ValT > ok_(Self&& self)
+    {
+        if (self.is_ok())
+            return fwd_t_(std::forward< Self >(self));
+        else
+            return {};
+    }
+
+    template<typename Self>
+    static constexpr std::optional< ValE > err_(Self&& self)
+    {
+        if (self.is_err())
+            return fwd_e_(std::forward< Self >(self));
+        else
+            return {};
+    }
+
+    template<typename Self, typename U>
+    static constexpr T unwrap_or_(Self&& self, U&& default_value)
+    {
+        static_assert(details::is_equiv_v< T, U >, 
+            "Default value type is not equivalent to Ok type");
+        if (self.is_ok())
+            return static_cast< T >(fwd_t_(std::forward< Self >(self)));
+        else
+            return std::forward< U >(default_value);
+    }
+
+    template<typename Self,
+        typename R = Result< details::like_t< Self&, T >, details::like_t< Self&, E > > >
+    static constexpr R borrow_(Self & self)
+    {
+        if (self.is_ok())
+        {
+            if constexpr (std::is_void_v< T >)
+                return Ok();
+            else
+                return details::Ok< details::like_t< Self&, T > >( self.get_t_() );
+        }
+        if constexpr (std::is_void_v< E >)
+            return details::Err< details::Unit >(details::Unit{});
+        else
+            return details::Err< details::like_t< Self&, E > >( self.get_e_() );
+    }
+
+    template<typename Self, typename Fn>
+    static constexpr T unwrap_or_else_(Self&& self, Fn&& fn)
+    {
+        static_assert(details::is_op_v< T, Fn, details::like_t< Self, E > >,
+            "Function is not of signature Fn(E) -> T");
+        if (self.is_ok())
+            return static_cast< T >(fwd_t_(std::forward< Self >(self)));
+        else
+            return call_with_e_(std::forward< Self >(self), std::forward< Fn >(fn));
+    }
+
+    template<typename Self, typename Fn,
+        typename U = std::decay_t< details::call_result_t< Fn, details::like_t< Self, T > > > >
+    static constexpr Result< U, E > map_(Self&& self, Fn&& fn)
+    {
+        using R = Result< U, E >;
+        if (!self.is_ok())
+            return err_into_< R >(std::forward< Self >(self));
+        if constexpr (std::is_void_v< U >)
+            return call_with_t_(std::forward< Self >(self), std::forward< Fn >(fn)), R(in_place_ok);
+        else
+            return R(in_place_ok, call_with_t_(std::forward< Self >(self), std::forward< Fn >(fn)));
+    }
+
+    template<typename Self, typename Fn,
+        typename F = std::decay_t< details::call_result_t< Fn, details::like_t< Self, E > > > >
+    static constexpr Result< T, F > map_err_(Self&& self, Fn&& fn)
+    {
+        using R = Result< T, F >;
+        if (self.is_ok())
+            return ok_into_< R >(std::forward< Self >(self));
+        if constexpr (std::is_void_v< F >)
+            return call_with_e_(std::forward< Self >(self), std::forward< Fn >(fn)), traced_err_< R >(self);
+        else
+            return traced_err_< R >(self, call_with_e_(std::forward< Self >(self), std::forward< Fn >(fn)));
+    }
+
+    template<typename Self, typename Res, typename R = std::decay_t< Res > >
+    static constexpr R and_impl_(Self&& self, Res&& res)
+    {
+        static_assert(details::is_result_v< R >,
+            "Argument is not a Result type");
+        static_assert(details::is_equiv_v< ErrE, typename R::ErrE >,
+            "Err type of argument and object is not equivalent");
+
+        if (self.is_ok())
+            return std::forward< Res >(res);
+        else
+            return err_into_< R >(std::forward< Self >(self));
+    }
+
+    template<typename Self, typename Fn,
+        typename Res = details::call_result_t< Fn, details::like_t< Self, T > > >
+    static constexpr Res and_then_(Self&& self, Fn&& fn)
+    {
+        static_assert(details::is_result_v< Res >,
+            "Return value is not a Result type");
+        static_assert(details::is_equiv_v< ErrE, typename Res::ErrE >,
+            "Err type of return value and object is not equivalent");
+
+        if (self.is_ok())
+            return call_with_t_(std::forward< Self >(self), std::forward< Fn >(fn));
+        else
+            return err_into_< Res >(std::forward< Self >(self));
+    }
+
+    template<typename Self, typename Res, typename R = std::decay_t< Res > >
+    static constexpr R or_impl_(Self&& self, Res&& res)
+    {
+        static_assert(details::is_result_v< R >,
+            "Argument is not a Result type");
+        static_assert(details::is_equiv_v< OkT, typename R::OkT >,
+            "Ok type of argument and object is not equivalent");
+
+        if (self.is_ok())
+            return ok_into_< R >(std::forward< Self >(self));
+        else
+            return std::forward< Res >(res);
+    }
+
+    template<typename Self, typename Fn,
+        typename Res = details::call_result_t< Fn, details::like_t< Self, E > > >
+    static constexpr Res or_else_(Self&& self, Fn&& fn)
+    {
+        static_assert(details::is_result_v< Res >,
+            "Return value is not a Result type");
+        static_assert(details::is_equiv_v< OkT, typename Res::OkT >,
+            "Ok type of return value and object is not equivalent");
+
+        if (self.is_ok())
+            return ok_into_< Res >(std::forward< Self >(self));
+        else
+            return call_with_e_(std::forward< Self >(self), std::forward< Fn >(fn));
+    }
+
+    template<typename Self, typename Attach>
+    static constexpr ResT context_(Self&& self, Attach&& attach)
+    {
+        static_assert(error_context< E >::enabled,
+            "Err type has no error_context specialization");
+        if (RESULT_LIKELY(self.is_ok()))
+            return ok_into_< ResT >(std::forward< Self >(self));
+        return context_err_(self, E(fwd_e_(std::forward< Self >(self))), attach);
+    }
+
+    // Kept out of line so call sites only pay for the Ok check
+    template<typename Er, typename Attach>
+    RESULT_COLD static constexpr ResT context_err_(ResT const& src, Er&& e, Attach& attach)
+    {
+        return traced_err_< ResT >(src, attach(std::forward< Er >(e)));
+    }
+
+    template<typename U, typename F>
+    friend class Result;
+    friend struct details::TryAccess;
+};
+
+
+namespace details {
+
+template<typename A>
+std::size_t hash_payload(A const * a)
+{
+    if constexpr (std::is_void_v< A >)
+        return 0;
+    else
+        return std::hash< std::remove_cv_t< A > >{}(*a);
+}
+
+template<typename A, typename = void>
+constexpr bool is_hashable_v = std::is_void_v< A >;
+
+template<typename A>
+constexpr bool is_hashable_v< A, std::void_t<
+    decltype(std::hash< std::remove_cv_t< A > >{}(std::declval< A const& >())) > > = true;
+
+// Hashes the active payload; Err hashes are remixed with a constant so that
+// Ok(x) and Err(x) land apart. Equal Results hash equal.
+template<typename T, typename E, bool = is_hashable_v< std::remove_reference_t< T > >
+    && is_hashable_v< std::remove_reference_t< E > >>
+struct ResultHash
+{
+    std::size_t operator()(Result< T, E > const& res) const
+    {
+        if (res.is_ok())
+            return hash_payload< std::remove_reference_t< T > >(res.value_ptr());
+        std::size_t h = hash_payload< std::remove_reference_t< E > >(res.error_ptr());
+        return (h ^ std::size_t(0x9e3779b97f4a7c15ull)) * std::size_t(0xff51afd7ed558ccdull);
+    }
+};
+
+// Disabled when a payload is not hashable, as for std::optional
+template<typename T, typename E>
+struct ResultHash< T, E, false >
+{
+    ResultHash() = delete;
+    ResultHash(ResultHash const&) = delete;
+    ResultHash(ResultHash&&) = delete;
+    ResultHash& operator=(ResultHash const&) = delete;
+    ResultHash& operator=(ResultHash&&) = delete;
+};
+
+} /* namespace details */
+
+namespace std {
+
+template<typename T, typename E>
+struct hash< Result< T, E > > : details::ResultHash< T, E > {};
+
+// Results whose payloads take the allocator are constructed with it by
+// allocator-aware containers
+template<typename T, typename E, typename Alloc>
+struct uses_allocator< Result< T, E >, Alloc > : bool_constant<
+    uses_allocator_v< details::value_t< T >, Alloc > || uses_allocator_v< details::value_t< E >, Alloc > > {};
+
+} /* namespace std */
+
+
+// Compile-time description of how a Result< T, E > is laid out, for
+// pinning sizes in code that packs Results into cache lines:
+//
+//   static_assert(result_layout< Node &, NotFound >::niche_packed);
+//   static_assert(result_fits_v< int64_t, Errc, 16 >);
+template<typename T, typename E>
+struct result_layout
+{
+    using type = Result< T, E >;
+
+    static constexpr std::size_t size = sizeof(type);
+    static constexpr std::size_t alignment = alignof(type);
+    static constexpr std::size_t ok_size = sizeof(details::stored_t< details::value_t< T > >);
+    static constexpr std::size_t err_size = sizeof(details::stored_t< details::err_storage_t< details::value_t< E > > >);
+    static constexpr std::size_t payload_size = ok_size < err_size ? err_size : ok_size;
+    // Bytes spent on the discriminant and its padding
+    static constexpr std::size_t overhead = size - payload_size;
+
+    static constexpr bool niche_packed = 
+        details::use_niche_v< details::value_t< T >, details::err_storage_t< details::value_t< E > > >;
+    static constexpr bool trivially_copyable = std::is_trivially_copyable_v< type >;
+    static constexpr bool trivially_destructible = std::is_trivially_destructible_v< type >;
+};
+
+template<typename T, typename E, std::size_t Budget>
+constexpr bool result_fits_v = result_layout< T, E >::size <= Budget;
+
+namespace details {
+
+// Unchecked access for the TRY macros, which test the discriminant once
+// and then move the payload straight out.
+struct TryAccess
+{
+    template<typename Res>
+    static constexpr bool is_err(Res const& res) { return res.is_err(); }
+
+    template<typename Res>
+    static constexpr auto take_err(Res & res) { return res.move_err_(); }
+
+    // The Err of res with its return trace, copied out of an lvalue
+    template<typename Res>
+    static constexpr auto forward_err(Res&& res)
+    {
+        if constexpr (std::is_lvalue_reference_v< Res >)
+            return res.copy_err_();
+        else
+            return res.move_err_();
+    }
+
+    template<typename Res>
+    static constexpr decltype(auto) take_ok(Res & res) { return res.move_t_(); }
+
+#if defined(RESULT_TRACE)
+    template<typename Res>
+    static constexpr void trace_hop(Res & res, SourceLocation loc) { res.trace_().push(loc); }
+#endif
+};
+
+} /* namespace details */
+
+#if defined(RESULT_TRACE)
+#define RESULT_TRACE_HOP_AT_(res, loc) ::details::TryAccess::trace_hop(res, loc)
+#else
+#define RESULT_TRACE_HOP_AT_(res, loc) ((void)0)
+#endif
+#define RESULT_TRACE_HOP_(res) RESULT_TRACE_HOP_AT_(res, ::details::SourceLocation::current())
+
+#define RESULT_CONCAT_IMPL_(a, b) a##b
+#define RESULT_CONCAT_(a, b) RESULT_CONCAT_IMPL_(a, b)
+
+// Evaluates to the Ok value of a Result, or returns its Err from the
+// enclosing function. Relies on GNU statement expressions.
+#if defined(__GNUC__)
+#define TRY(...) \
+    RESULT_TRY_IMPL_(RESULT_CONCAT_(result_try_, __COUNTER__), __VA_ARGS__)
+
+#define RESULT_TRY_IMPL_(tmp, ...) \
+    __extension__ ({ \
+        auto tmp = (__VA_ARGS__); \
+        if (RESULT_UNLIKELY(::details::TryAccess::is_err(tmp))) { \
+            RESULT_INSTRUMENT_TRY_(); \
+            RESULT_TRACE_HOP_(tmp); \
+            return ::details::TryAccess::take_err(tmp); \
         } \
-        res.unwrap(); \
+        ::details::TryAccess::take_ok(tmp); \
     })
+#endif
+
+// Portable TRY for Results whose Ok value is void or not needed
+#define TRY_VOID(...) \
+    RESULT_TRY_VOID_IMPL_(RESULT_CONCAT_(result_try_, __COUNTER__), __VA_ARGS__)
+
+#define RESULT_TRY_VOID_IMPL_(tmp, ...) \
+    do { \
+        auto tmp = (__VA_ARGS__); \
+        if (RESULT_UNLIKELY(::details::TryAccess::is_err(tmp))) { \
+            RESULT_INSTRUMENT_TRY_(); \
+            RESULT_TRACE_HOP_(tmp); \
+            return ::details::TryAccess::take_err(tmp); \
+        } \
+    } while (0)
+
+// Portable form of TRY, e.g. TRY_ASSIGN(auto header, parse_header(buf));
+// Expands to several statements, so it cannot be the body of an unbraced if.
+#define TRY_ASSIGN(lhs, ...) \
+    RESULT_TRY_ASSIGN_IMPL_(RESULT_CONCAT_(result_try_, __COUNTER__), lhs, __VA_ARGS__)
+
+#define RESULT_TRY_ASSIGN_IMPL_(tmp, lhs, ...) \
+    auto tmp = (__VA_ARGS__); \
+    if (RESULT_UNLIKELY(::details::TryAccess::is_err(tmp))) { \
+        RESULT_INSTRUMENT_TRY_(); \
+        RESULT_TRACE_HOP_(tmp); \
+        return ::details::TryAccess::take_err(tmp); \
+    } \
+    lhs = ::details::TryAccess::take_ok(tmp)
+
+#if defined(RESULT_INSTRUMENT)
+#include "result_instrument.hpp"
+#endif
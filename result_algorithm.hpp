@@ -0,0 +1,127 @@
+#pragma once
+
+#include "result.hpp"
+
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace details {
+
+template<typename Range, typename = void>
+struct has_size : std::false_type {};
+
+template<typename Range>
+struct has_size< Range, std::void_t< decltype(std::size(std::declval< Range& >())) > > 
+    : std::true_type {};
+
+template<typename Container, typename = void>
+struct has_reserve : std::false_type {};
+
+template<typename Container>
+struct has_reserve< Container, 
+    std::void_t< decltype(std::declval< Container& >().reserve(std::size_t{})) > > 
+    : std::true_type {};
+
+// Reserve room for every element of range if its size is known up front
+template<typename Container, typename Range>
+void reserve_for(Container & c, Range & range)
+{
+    if constexpr (has_size< Range >::value && has_reserve< Container >::value)
+        c.reserve(static_cast< typename Container::size_type >(std::size(range)));
+}
+
+// Element of range, moved out if the range itself is an rvalue
+template<typename Range, typename Elem>
+constexpr decltype(auto) forward_elem(Elem&& elem)
+{
+    if constexpr (std::is_lvalue_reference_v< Range >)
+        return static_cast< Elem&& >(elem);
+    else
+        return std::move(elem);
+}
+
+template<typename Range>
+using range_elem_t = std::decay_t< decltype(*std::begin(std::declval< Range& >())) >;
+
+} /* namespace details */
+
+
+// Turns a range of Result< T, E > into a Result of a container of T, stopping
+// at the first Err. Sized ranges are reserved for up front.
+template<typename Container = void, typename Range>
+auto collect(Range&& range)
+{
+    using ResIn = details::range_elem_t< Range >;
+    static_assert(details::is_result_v< ResIn >,
+        "Range elements are not a Result type");
+    using T = typename ResIn::value_type;
+    using E = typename ResIn::error_type;
+    using C = std::conditional_t< std::is_void_v< Container >, std::vector< T >, Container >;
+    using ResOut = Result< C, E >;
+
+    C out;
+    details::reserve_for(out, range);
+    for (auto&& elem : range)
+    {
+        auto&& res = details::forward_elem< Range >(elem);
+        if (RESULT_UNLIKELY(res.is_err()))
+            return ResOut(details::TryAccess::forward_err(std::forward< decltype(res) >(res)));
+        out.push_back(std::forward< decltype(res) >(res).unwrap());
+    }
+    return ResOut(in_place_ok, std::move(out));
+}
+
+// Haskell-style name for collect
+template<typename Range>
+auto sequence(Range&& range)
+{
+    return collect(std::forward< Range >(range));
+}
+
+// Folds fn(acc, elem) -> Result< Acc, E > over range, stopping at the
+// first Err.
+template<typename Range, typename Acc, typename Fn>
+auto try_fold(Range&& range, Acc init, Fn&& fn)
+{
+    using ResOut = std::decay_t< std::invoke_result_t< Fn&, Acc&&,
+        decltype(details::forward_elem< Range >(*std::begin(range))) > >;
+    static_assert(details::is_result_v< ResOut >,
+        "Function is not of signature Fn(Acc, Elem) -> Result<Acc, E>");
+
+    for (auto&& elem : range)
+    {
+        ResOut res = details::invoke(fn, std::move(init), details::forward_elem< Range >(elem));
+        if (RESULT_UNLIKELY(res.is_err()))
+            return res;
+        init = std::move(res).unwrap();
+    }
+    return ResOut(in_place_ok, std::move(init));
+}
+
+// Maps fn(elem) -> Result< U, E > over range into a Result of a container
+// of U, stopping at the first Err.
+template<typename Container = void, typename Range, typename Fn>
+auto try_transform(Range&& range, Fn&& fn)
+{
+    using ResFn = std::decay_t< std::invoke_result_t< Fn&,
+        decltype(details::forward_elem< Range >(*std::begin(range))) > >;
+    static_assert(details::is_result_v< ResFn >,
+        "Function is not of signature Fn(Elem) -> Result<U, E>");
+    using U = typename ResFn::value_type;
+    using E = typename ResFn::error_type;
+    using C = std::conditional_t< std::is_void_v< Container >, std::vector< U >, Container >;
+    using ResOut = Result< C, E >;
+
+    C out;
+    details::reserve_for(out, range);
+    for (auto&& elem : range)
+    {
+        ResFn res = details::invoke(fn, details::forward_elem< Range >(elem));
+        if (RESULT_UNLIKELY(res.is_err()))
+            return ResOut(details::TryAccess::take_err(res));
+        out.push_back(std::move(res).unwrap());
+    }
+    return ResOut(in_place_ok, std::move(out));
+}
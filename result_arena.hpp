@@ -0,0 +1,219 @@
+#pragma once
+
+#include "result.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <string_view>
+
+// Rich errors without a heap allocation per failure. An ErrorArena hands
+// out ErrorNodes (message, source location, cause) from a bump allocator,
+// and the error payload is an ErrorRef: a non-null pointer to a node, so
+// Result< void, ErrorRef > is pointer-sized and Result< T, ErrorRef > adds
+// one pointer to T. Chaining a cause stores a pointer to the inner node,
+// so nothing is copied:
+//
+//   return parse(buf).map_err([&](ErrorRef e) { return arena.make("bad header", e); });
+//
+// reset() releases every node at once, typically at the end of a request;
+// ErrorRefs into the arena must not outlive it.
+
+class ErrorArena;
+
+struct ErrorNode
+{
+    std::string_view message;
+    details::SourceLocation location;
+    ErrorNode const * cause;
+    // Arena the node lives in, where context on it is allocated too
+    ErrorArena * arena;
+};
+
+class ErrorRef
+{
+    ErrorNode const * node_;
+
+    constexpr explicit ErrorRef(ErrorNode const * node) : node_(node) {}
+
+    friend class ErrorArena;
+    friend struct niche_traits< ErrorRef >;
+
+public:
+    std::string_view message() const { return node_->message; }
+    details::SourceLocation const& location() const { return node_->location; }
+    ErrorArena & arena() const { return *node_->arena; }
+
+    bool has_cause() const { return node_->cause != nullptr; }
+    ErrorRef cause() const { return ErrorRef(node_->cause); }
+
+    ErrorRef root_cause() const
+    {
+        ErrorNode const * n = node_;
+        while (n->cause)
+            n = n->cause;
+        return ErrorRef(n);
+    }
+
+    friend bool operator==(ErrorRef a, ErrorRef b) { return a.node_ == b.node_; }
+    friend bool operator!=(ErrorRef a, ErrorRef b) { return a.node_ != b.node_; }
+};
+
+template<>
+struct niche_traits< ErrorRef >
+{
+    static constexpr bool has_niche = true;
+    static constexpr ErrorRef niche() { return ErrorRef(nullptr); }
+    static constexpr bool is_niche(ErrorRef const& r) { return r.node_ == nullptr; }
+};
+
+#if !defined(RESULT_TRACE)
+static_assert(sizeof(Result< void, ErrorRef >) == sizeof(void *));
+#endif
+
+
+// Chunked bump allocator for error nodes and their messages. The newest
+// chunk is kept across reset(), so a request loop whose errors fit in one
+// chunk stops allocating after the first request. Not thread-safe; use one
+// arena per thread or per request.
+class ErrorArena
+{
+    struct Chunk
+    {
+        Chunk * next;
+        std::size_t size;
+    };
+
+    std::size_t chunk_size_;
+    Chunk * chunks_ = nullptr;
+    unsigned char * cur_ = nullptr;
+    unsigned char * end_ = nullptr;
+
+public:
+    explicit ErrorArena(std::size_t chunk_size = 4096) : chunk_size_(chunk_size) {}
+
+    ErrorArena(ErrorArena const&) = delete;
+    ErrorArena& operator=(ErrorArena const&) = delete;
+
+    ~ErrorArena()
+    {
+        while (chunks_)
+        {
+            Chunk * next = chunks_->next;
+            ::operator delete(chunks_);
+            chunks_ = next;
+        }
+    }
+
+    void * allocate(std::size_t size, std::size_t align)
+    {
+        auto p = reinterpret_cast< std::uintptr_t >(cur_);
+        auto aligned = (p + align - 1) & ~std::uintptr_t(align - 1);
+        if (RESULT_UNLIKELY(!cur_ || aligned + size > reinterpret_cast< std::uintptr_t >(end_)))
+        {
+            grow_(size + align);
+            p = reinterpret_cast< std::uintptr_t >(cur_);
+            aligned = (p + align - 1) & ~std::uintptr_t(align - 1);
+        }
+        cur_ = reinterpret_cast< unsigned char * >(aligned + size);
+        return reinterpret_cast< void * >(aligned);
+    }
+
+    // Copy of s that lives as long as the arena's contents
+    std::string_view copy(std::string_view s)
+    {
+        if (s.empty())
+            return {};
+        auto * p = static_cast< char * >(allocate(s.size(), 1));
+        std::memcpy(p, s.data(), s.size());
+        return std::string_view(p, s.size());
+    }
+
+    // Error whose message is copied into the arena
+    ErrorRef make(std::string_view message,
+        details::SourceLocation loc = details::SourceLocation::current())
+    {
+        return node_(copy(message), loc, nullptr);
+    }
+
+    ErrorRef make(std::string_view message, ErrorRef cause,
+        details::SourceLocation loc = details::SourceLocation::current())
+    {
+        return node_(copy(message), loc, cause.node_);
+    }
+
+    // As make, for messages that outlive the arena such as string literals;
+    // only the node is allocated
+    ErrorRef make_static(std::string_view message,
+        details::SourceLocation loc = details::SourceLocation::current())
+    {
+        return node_(message, loc, nullptr);
+    }
+
+    ErrorRef make_static(std::string_view message, ErrorRef cause,
+        details::SourceLocation loc = details::SourceLocation::current())
+    {
+        return node_(message, loc, cause.node_);
+    }
+
+    // Releases every error at once, keeping the most recent chunk for reuse
+    void reset()
+    {
+        if (!chunks_)
+            return;
+        while (Chunk * next = chunks_->next)
+        {
+            chunks_->next = next->next;
+            ::operator delete(next);
+        }
+        cur_ = reinterpret_cast< unsigned char * >(chunks_ + 1);
+        end_ = cur_ + chunks_->size;
+    }
+
+    // Arena of the calling thread
+    static ErrorArena & local()
+    {
+        thread_local ErrorArena arena;
+        return arena;
+    }
+
+private:
+    void grow_(std::size_t min_size)
+    {
+        std::size_t size = min_size > chunk_size_ ? min_size : chunk_size_;
+        auto * chunk = static_cast< Chunk * >(::operator new(sizeof(Chunk) + size));
+        chunk->size = size;
+        chunk->next = chunks_;
+        chunks_ = chunk;
+        cur_ = reinterpret_cast< unsigned char * >(chunk + 1);
+        end_ = cur_ + size;
+    }
+
+    ErrorRef node_(std::string_view message, details::SourceLocation loc, ErrorNode const * cause)
+    {
+        void * p = allocate(sizeof(ErrorNode), alignof(ErrorNode));
+        return ErrorRef(::new (p) ErrorNode{ message, loc, cause, this });
+    }
+};
+
+
+// Context on an ErrorRef is a new node whose cause is the original error,
+// allocated in the arena of that error so that both share one lifetime.
+// Literals are referenced, formatted messages copied into the arena.
+template<>
+struct error_context< ErrorRef >
+{
+    static constexpr bool enabled = true;
+
+    static ErrorRef attach(ErrorRef e, std::string_view literal, details::SourceLocation loc)
+    {
+        return e.arena().make_static(literal, e, loc);
+    }
+
+    template<typename Msg>
+    static ErrorRef attach_formatted(ErrorRef e, Msg&& msg, details::SourceLocation loc)
+    {
+        return e.arena().make(std::string_view(msg), e, loc);
+    }
+};
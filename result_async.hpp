@@ -0,0 +1,170 @@
+#pragma once
+
+#include "result.hpp"
+
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+// Lazy asynchronous Result. An AsyncResult< T, E, Start > wraps a start
+// function that takes a receiver and, possibly later and on another thread,
+// calls it once with a Result< T, E >&&. Nothing runs until start() is
+// called with the final receiver.
+//
+//   read_header(sock)                              // AsyncResult< Buf, Errc, ... >
+//       .map(parse)
+//       .and_then([&](Header h) { return read_body(sock, h); })
+//       .start([](Result< Body, Errc >&& res) { ... });
+//
+// Each combinator wraps the previous start function by value, so a chain is
+// a single object whose type spells out the pipeline: no shared state, no
+// allocation and no locking. Continuations run inline on whichever thread
+// completes the operation. Storing the final receiver until completion is
+// up to the source.
+
+template<typename T, typename E, typename Start>
+class AsyncResult;
+
+namespace details {
+
+template<typename A>
+struct is_async_result : std::false_type {};
+
+template<typename T, typename E, typename Start>
+struct is_async_result< AsyncResult< T, E, Start > > : std::true_type {};
+
+template<typename A>
+constexpr bool is_async_result_v = is_async_result< std::decay_t< A > >::value;
+
+// fn called with the Ok or Err payload moved out of res, or with no
+// arguments for a void payload
+template<typename Fn, typename Res>
+decltype(auto) invoke_ok(Fn & fn, Res && res)
+{
+    if constexpr (std::is_void_v< typename std::decay_t< Res >::value_type >)
+        return std::invoke(fn);
+    else
+        return std::invoke(fn, std::move(res).unwrap());
+}
+
+template<typename Fn, typename Res>
+decltype(auto) invoke_err(Fn & fn, Res && res)
+{
+    if constexpr (std::is_void_v< typename std::decay_t< Res >::error_type >)
+        return std::invoke(fn);
+    else
+        return std::invoke(fn, std::move(res).unwrap_err());
+}
+
+} /* namespace details */
+
+
+template<typename T, typename E, typename Start>
+class AsyncResult
+{
+    using ResT = Result< T, E >;
+
+    Start start_;
+
+public:
+    using value_type = T;
+    using error_type = E;
+
+    explicit AsyncResult(Start start) : start_(std::move(start)) {}
+
+    // Runs the pipeline, handing the final Result< T, E >&& to recv
+    template<typename Receiver>
+    void start(Receiver&& recv) &&
+    {
+        std::move(start_)(std::forward< Receiver >(recv));
+    }
+
+    template<typename Fn,
+        typename U = std::decay_t< details::call_result_t< Fn&, details::like_t< ResT&&, T > > > >
+    auto map(Fn&& fn) &&
+    {
+        return std::move(*this).template then_< U, E >(std::forward< Fn >(fn),
+            [](auto& f, ResT&& res, auto& recv) { recv(std::move(res).map(f)); });
+    }
+
+    template<typename Fn,
+        typename F = std::decay_t< details::call_result_t< Fn&, details::like_t< ResT&&, E > > > >
+    auto map_err(Fn&& fn) &&
+    {
+        return std::move(*this).template then_< T, F >(std::forward< Fn >(fn),
+            [](auto& f, ResT&& res, auto& recv) { recv(std::move(res).map_err(f)); });
+    }
+
+    // fn may return a Result< U, E >, applied inline, or another
+    // AsyncResult< U, E, ... >, which is started with the downstream receiver
+    template<typename Fn,
+        typename Res = std::decay_t< details::call_result_t< Fn&, details::like_t< ResT&&, T > > > >
+    auto and_then(Fn&& fn) &&
+    {
+        static_assert(std::is_same_v< typename Res::error_type, E >,
+            "Function is not of signature Fn(T) -> Result<U, E> or AsyncResult<U, E>");
+        using U = typename Res::value_type;
+        return std::move(*this).template then_< U, E >(std::forward< Fn >(fn),
+            [](auto& f, ResT&& res, auto& recv)
+            {
+                if constexpr (!details::is_async_result_v< Res >)
+                    recv(std::move(res).and_then(f));
+                else if (res.is_ok())
+                    details::invoke_ok(f, std::move(res)).start(std::move(recv));
+                else
+                    recv(Result< U, E >(details::TryAccess::take_err(res)));
+            });
+    }
+
+    // fn may return a Result< T, F > or an AsyncResult< T, F, ... >
+    template<typename Fn,
+        typename Res = std::decay_t< details::call_result_t< Fn&, details::like_t< ResT&&, E > > > >
+    auto or_else(Fn&& fn) &&
+    {
+        static_assert(std::is_same_v< typename Res::value_type, T >,
+            "Function is not of signature Fn(E) -> Result<T, F> or AsyncResult<T, F>");
+        using F = typename Res::error_type;
+        return std::move(*this).template then_< T, F >(std::forward< Fn >(fn),
+            [](auto& f, ResT&& res, auto& recv)
+            {
+                if constexpr (!details::is_async_result_v< Res >)
+                    recv(std::move(res).or_else(f));
+                else if (res.is_err())
+                    details::invoke_err(f, std::move(res)).start(std::move(recv));
+                else if constexpr (std::is_void_v< T >)
+                    recv(Result< T, F >(in_place_ok));
+                else
+                    recv(Result< T, F >(in_place_ok, details::TryAccess::take_ok(res)));
+            });
+    }
+
+private:
+    // New stage whose receiver passes each Result through step(fn, res, recv)
+    template<typename U, typename F, typename Fn, typename Step>
+    auto then_(Fn&& fn, Step step) &&
+    {
+        auto start = [s = std::move(start_), f = std::forward< Fn >(fn), step](auto&& recv) mutable
+        {
+            std::move(s)([f = std::move(f), step, r = std::forward< decltype(recv) >(recv)](ResT&& res) mutable
+            {
+                step(f, std::move(res), r);
+            });
+        };
+        return AsyncResult< U, F, decltype(start) >(std::move(start));
+    }
+};
+
+
+// AsyncResult from a start function taking a receiver of Result< T, E >&&
+template<typename T, typename E, typename Start>
+AsyncResult< T, E, std::decay_t< Start > > async_result(Start&& start)
+{
+    return AsyncResult< T, E, std::decay_t< Start > >(std::forward< Start >(start));
+}
+
+// AsyncResult that completes with res as soon as it is started
+template<typename T, typename E>
+auto async_ready(Result< T, E > res)
+{
+    return async_result< T, E >([res = std::move(res)](auto&& recv) mutable { recv(std::move(res)); });
+}
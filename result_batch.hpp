@@ -0,0 +1,220 @@
+#pragma once
+
+#include "result.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace details {
+
+constexpr int popcount64(std::uint64_t w)
+{
+#if defined(__GNUC__)
+    return __builtin_popcountll(w);
+#else
+    int n = 0;
+    for (; w; w &= w - 1)
+        ++n;
+    return n;
+#endif
+}
+
+} /* namespace details */
+
+
+// Column of Result< T, E > stored as structure-of-arrays: a validity bitmap,
+// a dense array of T with one slot per row, and a sparse side table of
+// errors ordered by row. Err rows hold a value-initialized T in the dense
+// array, so whole-column operations can run without branching on the
+// bitmap where that is safe.
+template<typename T, typename E>
+class ResultBatch
+{
+    static_assert(std::is_default_constructible_v< T >,
+        "Ok type must be default constructible to fill Err rows");
+
+    using Word = std::uint64_t;
+    static constexpr std::size_t word_bits = 64;
+
+    std::vector< Word > valid_;
+    std::vector< T > values_;
+    std::vector< std::pair< std::size_t, E > > errors_;
+
+public:
+    ResultBatch() = default;
+
+    void reserve(std::size_t rows)
+    {
+        values_.reserve(rows);
+        valid_.reserve((rows + word_bits - 1) / word_bits);
+    }
+
+    std::size_t size() const { return values_.size(); }
+    bool empty() const { return values_.empty(); }
+
+    void push_ok(T t)
+    {
+        set_valid_(values_.size(), true);
+        values_.push_back(std::move(t));
+    }
+
+    void push_err(E e)
+    {
+        set_valid_(values_.size(), false);
+        errors_.emplace_back(values_.size(), std::move(e));
+        values_.emplace_back();
+    }
+
+    void push_back(Result< T, E > res)
+    {
+        if (res.is_ok())
+            push_ok(std::move(res).unwrap());
+        else
+            push_err(std::move(res).unwrap_err());
+    }
+
+    bool is_ok(std::size_t row) const { return (valid_[row / word_bits] >> (row % word_bits)) & 1; }
+    bool is_err(std::size_t row) const { return !is_ok(row); }
+
+    // Borrowing view of one row. Looking up an Err row is a binary search
+    // in the side table.
+    Result< T const&, E const& > operator[](std::size_t row) const
+    {
+        if (is_ok(row))
+            return Result< T const&, E const& >(in_place_ok, values_[row]);
+        return Result< T const&, E const& >(in_place_err, find_err_(row));
+    }
+
+    // Dense payload column, including the filler values of Err rows
+    T const * values() const { return values_.data(); }
+    // Row bitmap, 64 rows per word, bit set for Ok rows
+    Word const * validity() const { return valid_.data(); }
+    std::vector< std::pair< std::size_t, E > > const& errors() const { return errors_; }
+
+    std::size_t count_ok() const
+    {
+        std::size_t n = 0;
+        for (Word w : valid_)
+            n += details::popcount64(w);
+        return n;
+    }
+
+    std::size_t count_err() const { return errors_.size(); }
+
+    // Applies fn to the value of every Ok row; Err rows get a
+    // value-initialized U. Words of 64 Ok rows run as a plain loop, so
+    // mostly-Ok columns still vectorize.
+    template<typename Fn, typename U = std::decay_t< std::invoke_result_t< Fn&, T const& > > >
+    ResultBatch< U, E > map(Fn&& fn) const&
+    {
+        ResultBatch< U, E > out;
+        out.valid_ = valid_;
+        out.errors_ = errors_;
+        out.values_.resize(values_.size());
+        for (std::size_t w = 0; w < valid_.size(); ++w)
+        {
+            std::size_t const first = w * word_bits;
+            std::size_t const last = std::min(first + word_bits, values_.size());
+            Word const bits = valid_[w];
+            if (bits == ~Word(0))
+            {
+                for (std::size_t i = first; i < last; ++i)
+                    out.values_[i] = details::invoke(fn, values_[i]);
+            }
+            else if (bits != 0)
+            {
+                for (std::size_t i = first; i < last; ++i)
+                    if ((bits >> (i - first)) & 1)
+                        out.values_[i] = details::invoke(fn, values_[i]);
+            }
+        }
+        return out;
+    }
+
+    // Applies fn to every slot of the dense column, including the filler
+    // value of each Err row, without looking at the bitmap. Only for fn
+    // that is defined, cheap and free of side effects on T(): a division
+    // by the value, for one, traps on the Err rows.
+    template<typename Fn, typename U = std::decay_t< std::invoke_result_t< Fn&, T const& > > >
+    ResultBatch< U, E > map_unchecked(Fn&& fn) const&
+    {
+        ResultBatch< U, E > out;
+        out.valid_ = valid_;
+        out.errors_ = errors_;
+        out.values_.resize(values_.size());
+        for (std::size_t i = 0; i < values_.size(); ++i)
+            out.values_[i] = details::invoke(fn, values_[i]);
+        return out;
+    }
+
+    template<typename Fn, typename F = std::decay_t< std::invoke_result_t< Fn&, E&& > > >
+    ResultBatch< T, F > map_err(Fn&& fn) &&
+    {
+        ResultBatch< T, F > out;
+        out.valid_ = std::move(valid_);
+        out.values_ = std::move(values_);
+        out.errors_.reserve(errors_.size());
+        for (auto& [row, e] : errors_)
+            out.errors_.emplace_back(row, details::invoke(fn, std::move(e)));
+        return out;
+    }
+
+    // Branch-free select between the value and the default, per row
+    std::vector< T > unwrap_or(T const& default_value) const
+    {
+        std::vector< T > out(values_.size());
+        for (std::size_t i = 0; i < values_.size(); ++i)
+            out[i] = is_ok(i) ? values_[i] : default_value;
+        return out;
+    }
+
+    // Ok values and errors, each in row order
+    std::pair< std::vector< T >, std::vector< E > > partition() &&
+    {
+        std::pair< std::vector< T >, std::vector< E > > out;
+        out.first.reserve(values_.size() - errors_.size());
+        out.second.reserve(errors_.size());
+        for (std::size_t i = 0; i < values_.size(); ++i)
+            if (is_ok(i))
+                out.first.push_back(std::move(values_[i]));
+        for (auto& [row, e] : errors_)
+            out.second.push_back(std::move(e));
+        return out;
+    }
+
+    // All values if every row is Ok, otherwise the error of the first Err row
+    Result< std::vector< T >, E > collect() &&
+    {
+        if (!errors_.empty())
+            return Result< std::vector< T >, E >(in_place_err, std::move(errors_.front().second));
+        return Result< std::vector< T >, E >(in_place_ok, std::move(values_));
+    }
+
+private:
+    void set_valid_(std::size_t row, bool ok)
+    {
+        if (row % word_bits == 0)
+            valid_.push_back(0);
+        valid_.back() |= Word(ok) << (row % word_bits);
+    }
+
+    E const& find_err_(std::size_t row) const
+    {
+        std::size_t lo = 0, hi = errors_.size();
+        while (hi - lo > 1)
+        {
+            std::size_t mid = lo + (hi - lo) / 2;
+            if (errors_[mid].first <= row)
+                lo = mid;
+            else
+                hi = mid;
+        }
+        return errors_[lo].second;
+    }
+
+    template<typename U, typename F>
+    friend class ResultBatch;
+};
@@ -0,0 +1,169 @@
+#pragma once
+
+#include "result.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
+#include <utility>
+
+namespace details {
+
+constexpr std::size_t cache_line = 64;
+
+constexpr std::size_t round_up_pow2(std::size_t n)
+{
+    std::size_t p = 1;
+    while (p < n)
+        p <<= 1;
+    return p;
+}
+
+} /* namespace details */
+
+
+// Bounded lock-free ring of Result< T, E > for exactly one producer thread
+// and one consumer thread. Results are constructed in place in the slot and
+// destroyed when popped. Occupancy follows from the two counters, so slots
+// carry no state of their own, and each side caches the other's counter on
+// its own cache line to touch shared lines only when the ring looks full or
+// empty. push_n and pop_n publish a whole batch with one release store.
+template<typename T, typename E>
+class ResultChannel
+{
+    using ResT = Result< T, E >;
+
+    struct Slot { alignas(ResT) unsigned char bytes[sizeof(ResT)]; };
+
+    // Consumer side
+    alignas(details::cache_line) std::atomic< std::size_t > head_{ 0 };
+    std::size_t tail_cache_ = 0;
+
+    // Producer side
+    alignas(details::cache_line) std::atomic< std::size_t > tail_{ 0 };
+    std::size_t head_cache_ = 0;
+
+    alignas(details::cache_line) std::unique_ptr< Slot[] > slots_;
+    std::size_t mask_;
+
+public:
+    // Capacity is rounded up to a power of two
+    explicit ResultChannel(std::size_t capacity)
+        : slots_(new Slot[details::round_up_pow2(capacity ? capacity : 1)])
+        , mask_(details::round_up_pow2(capacity ? capacity : 1) - 1)
+    {}
+
+    ResultChannel(ResultChannel const&) = delete;
+    ResultChannel& operator=(ResultChannel const&) = delete;
+
+    ~ResultChannel()
+    {
+        std::size_t const tail = tail_.load(std::memory_order_acquire);
+        for (std::size_t i = head_.load(std::memory_order_relaxed); i != tail; ++i)
+            slot_(i)->~ResT();
+    }
+
+    std::size_t capacity() const { return mask_ + 1; }
+
+    // Number of queued Results, exact only when both sides are idle
+    std::size_t size_approx() const
+    {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+
+    // Producer: false if the ring is full
+    bool try_push(ResT&& res) { return try_emplace_(std::move(res)); }
+    bool try_push(ResT const& res) { return try_emplace_(res); }
+
+    template<typename... Args>
+    bool try_emplace_ok(Args&&... args) { return try_emplace_(in_place_ok, std::forward< Args >(args)...); }
+
+    template<typename... Args>
+    bool try_emplace_err(Args&&... args) { return try_emplace_(in_place_err, std::forward< Args >(args)...); }
+
+    // Producer: moves up to n Results from first, returning how many fit
+    template<typename It>
+    std::size_t push_n(It first, std::size_t n)
+    {
+        std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (capacity() - (tail - head_cache_) < n)
+            head_cache_ = head_.load(std::memory_order_acquire);
+        std::size_t const count = std::min(n, capacity() - (tail - head_cache_));
+
+        Publish publish{ tail_, tail };
+        for (std::size_t i = 0; i < count; ++i, ++first)
+        {
+            ::new (raw_(tail)) ResT(std::move(*first));
+            ++tail;
+        }
+        return count;
+    }
+
+    // Consumer: empty optional if the ring is empty
+    std::optional< ResT > try_pop()
+    {
+        std::size_t const head = head_.load(std::memory_order_relaxed);
+        if (head == tail_cache_)
+        {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head == tail_cache_)
+                return std::nullopt;
+        }
+        std::optional< ResT > out(std::in_place, std::move(*slot_(head)));
+        slot_(head)->~ResT();
+        head_.store(head + 1, std::memory_order_release);
+        return out;
+    }
+
+    // Consumer: moves up to n Results to out, returning how many were taken
+    template<typename Out>
+    std::size_t pop_n(Out out, std::size_t n)
+    {
+        std::size_t head = head_.load(std::memory_order_relaxed);
+        if (tail_cache_ - head < n)
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+        std::size_t const count = std::min(n, tail_cache_ - head);
+
+        Publish publish{ head_, head };
+        for (std::size_t i = 0; i < count; ++i, ++out)
+        {
+            ResT * res = slot_(head);
+            *out = std::move(*res);
+            res->~ResT();
+            ++head;
+        }
+        return count;
+    }
+
+private:
+    // Stores the advanced counter on scope exit, so a batch interrupted by
+    // an exception still publishes the elements it completed
+    struct Publish
+    {
+        std::atomic< std::size_t > & counter;
+        std::size_t & value;
+        ~Publish() { counter.store(value, std::memory_order_release); }
+    };
+
+    void * raw_(std::size_t i) const { return slots_[i & mask_].bytes; }
+
+    ResT * slot_(std::size_t i) const { return std::launder(static_cast< ResT * >(raw_(i))); }
+
+    template<typename... Args>
+    bool try_emplace_(Args&&... args)
+    {
+        std::size_t const tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_cache_ == capacity())
+        {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail - head_cache_ == capacity())
+                return false;
+        }
+        ::new (raw_(tail)) ResT(std::forward< Args >(args)...);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+};
@@ -0,0 +1,243 @@
+#pragma once
+
+#include "result.hpp"
+
+#if !defined(__cpp_impl_coroutine)
+#error "result_coro.hpp requires C++20 coroutine support"
+#endif
+
+#include <coroutine>
+#include <cstddef>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+// Lets a function returning Result< T, E > be a coroutine, where
+//
+//   Result< Header, Errc > parse(Buf b)
+//   {
+//       auto magic = co_await read_u32(b);   // Err returns from parse
+//       co_return Ok(Header{ magic });
+//   }
+//
+// co_await unwraps an Ok or completes the coroutine with the Err, which is
+// a portable alternative to TRY. Only Results may be awaited, so the body
+// always runs to completion before the caller gets its Result.
+//
+// The Result is read out of the promise when the return object converts
+// to it, which requires a compiler that converts after the body has run
+// (GCC, MSVC and Clang 17 onwards).
+//
+// Frames are recycled through a small thread-local cache, so steady-state
+// calls do not reach the global allocator, and compilers that can elide the
+// frame allocation (HALO) are free to do so. Define RESULT_CORO_ALLOC(size)
+// and RESULT_CORO_FREE(ptr, size) to route frames to another allocator.
+
+namespace details {
+
+#if !defined(RESULT_CORO_ALLOC)
+// Per-thread free lists of coroutine frames, one per power-of-two size
+// class from 64 bytes to 4 KiB. Larger frames go to the global allocator.
+class CoroFrameCache
+{
+    struct Block { Block * next; };
+
+    static constexpr std::size_t min_shift = 6;
+    static constexpr std::size_t classes = 7;
+    static constexpr std::size_t max_cached = 16;
+
+    Block * free_[classes] = {};
+    std::size_t count_[classes] = {};
+
+    static constexpr std::size_t class_of_(std::size_t size)
+    {
+        std::size_t c = 0;
+        while ((std::size_t(1) << (c + min_shift)) < size)
+            ++c;
+        return c;
+    }
+
+public:
+    ~CoroFrameCache()
+    {
+        for (auto& head : free_)
+            while (head)
+                ::operator delete(std::exchange(head, head->next));
+    }
+
+    void * allocate(std::size_t size)
+    {
+        std::size_t c = class_of_(size);
+        if (c >= classes)
+            return ::operator new(size);
+        if (Block * b = free_[c])
+        {
+            free_[c] = b->next;
+            --count_[c];
+            return b;
+        }
+        return ::operator new(std::size_t(1) << (c + min_shift));
+    }
+
+    void deallocate(void * p, std::size_t size) noexcept
+    {
+        std::size_t c = class_of_(size);
+        if (c >= classes || count_[c] == max_cached)
+        {
+            // Once inlined into a promise's operator delete, GCC pairs this
+            // with the promise's operator new and warns
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+            ::operator delete(p);
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+            return;
+        }
+        free_[c] = ::new (p) Block{ free_[c] };
+        ++count_[c];
+    }
+
+    static CoroFrameCache & local()
+    {
+        thread_local CoroFrameCache cache;
+        return cache;
+    }
+};
+#endif
+
+template<typename T, typename E>
+class ResultPromise;
+
+// What a Result coroutine hands back to its caller; converts to the Result
+// stored in the promise and releases the frame.
+template<typename T, typename E>
+class ResultReturn
+{
+    using Handle = std::coroutine_handle< ResultPromise< T, E > >;
+
+    Handle h_;
+
+    friend class ResultPromise< T, E >;
+
+public:
+    explicit ResultReturn(Handle h) : h_(h) { h.promise().return_ = this; }
+    ResultReturn(ResultReturn const&) = delete;
+    ResultReturn& operator=(ResultReturn const&) = delete;
+
+    ~ResultReturn()
+    {
+        if (h_)
+            h_.destroy();
+    }
+
+    operator Result< T, E >()
+    {
+        Handle h = std::exchange(h_, nullptr);
+        Result< T, E > res = std::move(*h.promise().result_);
+        h.destroy();
+        return res;
+    }
+};
+
+// Awaiter that either resumes with the Ok value or stores the Err into the
+// awaiting coroutine's Result and leaves it suspended for good. Propagating
+// the Err counts as a TRY at the co_await for instrumentation and return
+// traces. An awaited lvalue is copied, as TRY does, so that the caller's
+// Result keeps its payload; an rvalue is used in place.
+template<typename Res>
+class ResultAwaiter
+{
+    using Stored = std::conditional_t< std::is_lvalue_reference_v< Res >, std::decay_t< Res >, Res&& >;
+
+    Stored res_;
+    SourceLocation loc_;
+
+public:
+    ResultAwaiter(Res && res, SourceLocation loc) : res_(std::forward< Res >(res)), loc_(loc) {}
+
+    bool await_ready() const noexcept { return RESULT_LIKELY(res_.is_ok()); }
+
+    template<typename Promise>
+    void await_suspend(std::coroutine_handle< Promise > h)
+    {
+        RESULT_INSTRUMENT_TRY_AT_(loc_);
+        RESULT_TRACE_HOP_AT_(res_, loc_);
+        h.promise().result_.emplace(TryAccess::take_err(res_));
+    }
+
+    auto await_resume() { return TryAccess::take_ok(res_); }
+};
+
+template<typename T, typename E>
+class ResultPromise
+{
+    std::optional< Result< T, E > > result_;
+    ResultReturn< T, E > * return_ = nullptr;
+
+    template<typename U, typename F>
+    friend class ResultReturn;
+    template<typename Res>
+    friend class ResultAwaiter;
+
+public:
+    ResultReturn< T, E > get_return_object()
+    {
+        return ResultReturn< T, E >(std::coroutine_handle< ResultPromise >::from_promise(*this));
+    }
+
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_always final_suspend() noexcept { return {}; }
+
+    template<typename U>
+    void return_value(U&& value) { result_.emplace(std::forward< U >(value)); }
+
+    template<typename Res, typename = std::enable_if_t< is_result_v< Res > > >
+    ResultAwaiter< Res > await_transform(Res&& res, SourceLocation loc = SourceLocation::current())
+    {
+        return ResultAwaiter< Res >(std::forward< Res >(res), loc);
+    }
+
+    // The body runs inside the initial call, so the exception leaves through
+    // the caller and the compiler frees the frame while unwinding; the
+    // return object gives up its handle to avoid destroying it twice.
+    void unhandled_exception()
+    {
+#if RESULT_HAS_EXCEPTIONS
+        return_->h_ = nullptr;
+        throw;
+#else
+        std::abort();
+#endif
+    }
+
+    static void * operator new(std::size_t size)
+    {
+#if defined(RESULT_CORO_ALLOC)
+        return RESULT_CORO_ALLOC(size);
+#else
+        return CoroFrameCache::local().allocate(size);
+#endif
+    }
+
+    static void operator delete(void * p, std::size_t size) noexcept
+    {
+#if defined(RESULT_CORO_ALLOC)
+        RESULT_CORO_FREE(p, size);
+#else
+        CoroFrameCache::local().deallocate(p, size);
+#endif
+    }
+};
+
+} /* namespace details */
+
+
+template<typename T, typename E, typename... Args>
+struct std::coroutine_traits< Result< T, E >, Args... >
+{
+    using promise_type = details::ResultPromise< T, E >;
+};
@@ -0,0 +1,205 @@
+#pragma once
+
+#include "result.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+// Type-erased error for Result< T, DynError >, for boundaries where the
+// error types of several libraries meet. Any error type converts to it
+// implicitly, so Err(e) and TRY work unchanged in a function returning
+// Result< T, DynError >:
+//
+//   Result< Reply, DynError > handle(Request const& req)
+//   {
+//       auto hdr = TRY(parse_header(req));    // Result< Header, ParseError >
+//       auto row = TRY(db.lookup(hdr.key));   // Result< Row, DbError >
+//       ...
+//   }
+//
+//   if (DbError const * e = res.unwrap_err().downcast< DbError >()) ...
+//
+// A DynError is 32 bytes: a pointer to a per-type table of functions and a
+// 24-byte buffer. Errors that fit the buffer and move without throwing are
+// stored inline, others on the heap. The table doubles as the type's
+// identity, so downcast needs no RTTI. DynError is move-only; a moved-from
+// DynError is empty.
+
+namespace details {
+
+constexpr std::size_t dyn_buffer_size = 3 * sizeof(void *);
+
+template<typename E>
+constexpr bool dyn_inline_v = sizeof(E) <= dyn_buffer_size && alignof(E) <= alignof(void *) &&
+    (is_trivially_relocatable_v< E > || std::is_nothrow_move_constructible_v< E >);
+
+struct DynErrorVtable
+{
+    // nullptr when there is nothing to do
+    void (*destroy)(void * buf) noexcept;
+    // nullptr when the buffer can be copied bytewise
+    void (*relocate)(void * dst, void * src) noexcept;
+    std::string (*message)(void const * buf);
+};
+
+template<typename E, typename = void>
+struct has_message_member : std::false_type {};
+template<typename E>
+struct has_message_member< E, std::void_t< decltype(std::declval< E const& >().message()) > > : std::true_type {};
+
+template<typename E, typename = void>
+struct has_what_member : std::false_type {};
+template<typename E>
+struct has_what_member< E, std::void_t< decltype(std::declval< E const& >().what()) > > : std::true_type {};
+
+// Text of an error: its message() or what(), the error itself if it is a
+// string, the value of an enum, or a placeholder
+template<typename E>
+std::string dyn_message(E const& e)
+{
+    if constexpr (has_message_member< E >::value)
+        return std::string(e.message());
+    else if constexpr (has_what_member< E >::value)
+        return std::string(e.what());
+    else if constexpr (std::is_convertible_v< E const&, std::string_view >)
+        return std::string(std::string_view(e));
+    else if constexpr (std::is_enum_v< E >)
+        return "error " + std::to_string(static_cast< std::underlying_type_t< E > >(e));
+    else
+        return "error";
+}
+
+template<typename E, bool Inline = dyn_inline_v< E > >
+struct DynErrorOps
+{
+    static E * get(void * buf) noexcept { return std::launder(static_cast< E * >(buf)); }
+    static E const * get(void const * buf) noexcept { return std::launder(static_cast< E const * >(buf)); }
+
+    template<typename... Args>
+    static void create(void * buf, Args&&... args) { ::new (buf) E(std::forward< Args >(args)...); }
+
+    static void destroy(void * buf) noexcept { get(buf)->~E(); }
+
+    static void relocate(void * dst, void * src) noexcept
+    {
+        ::new (dst) E(std::move(*get(src)));
+        get(src)->~E();
+    }
+
+    static std::string message(void const * buf) { return dyn_message(*get(buf)); }
+
+    static constexpr DynErrorVtable vtable = {
+        std::is_trivially_destructible_v< E > ? nullptr : &destroy,
+        is_trivially_relocatable_v< E > ? nullptr : &relocate,
+        &message,
+    };
+};
+
+template<typename E>
+struct DynErrorOps< E, false >
+{
+    static E * get(void * buf) noexcept { return *static_cast< E ** >(buf); }
+    static E const * get(void const * buf) noexcept { return *static_cast< E * const * >(buf); }
+
+    template<typename... Args>
+    static void create(void * buf, Args&&... args) { *static_cast< E ** >(buf) = new E(std::forward< Args >(args)...); }
+
+    static void destroy(void * buf) noexcept { delete get(buf); }
+
+    static std::string message(void const * buf) { return dyn_message(*get(buf)); }
+
+    static constexpr DynErrorVtable vtable = { &destroy, nullptr, &message };
+};
+
+} /* namespace details */
+
+
+class DynError
+{
+    details::DynErrorVtable const * vt_ = nullptr;
+    alignas(void *) unsigned char buf_[details::dyn_buffer_size];
+
+    template<typename E>
+    using Ops = details::DynErrorOps< E >;
+
+    DynError() = default;
+
+    template<typename E, typename... Args>
+    void create_(Args&&... args)
+    {
+        Ops< E >::create(buf_, std::forward< Args >(args)...);
+        vt_ = &Ops< E >::vtable;
+    }
+
+public:
+    // Wraps any error by value; a char const * is stored as the pointer
+    template<typename E, typename = std::enable_if_t<
+        !std::is_same_v< std::decay_t< E >, DynError > && !details::is_err_v< E > > >
+    DynError(E&& e) { create_< std::decay_t< E > >(std::forward< E >(e)); }
+
+    // An E built in place from args
+    template<typename E, typename... Args>
+    static DynError make(Args&&... args)
+    {
+        DynError d;
+        d.create_< E >(std::forward< Args >(args)...);
+        return d;
+    }
+
+    DynError(DynError&& other) noexcept { take_(other); }
+
+    DynError& operator=(DynError&& other) noexcept
+    {
+        if (this != &other)
+        {
+            reset_();
+            take_(other);
+        }
+        return *this;
+    }
+
+    DynError(DynError const&) = delete;
+    DynError& operator=(DynError const&) = delete;
+
+    ~DynError() { reset_(); }
+
+    bool empty() const { return vt_ == nullptr; }
+
+    template<typename E>
+    bool is() const { return vt_ == &Ops< E >::vtable; }
+
+    // The wrapped error if it is exactly an E, nullptr otherwise
+    template<typename E>
+    E * downcast() { return is< E >() ? Ops< E >::get(buf_) : nullptr; }
+
+    template<typename E>
+    E const * downcast() const { return is< E >() ? Ops< E >::get(buf_) : nullptr; }
+
+    std::string message() const { return vt_ ? vt_->message(buf_) : std::string(); }
+
+private:
+    void take_(DynError & other) noexcept
+    {
+        vt_ = std::exchange(other.vt_, nullptr);
+        if (!vt_)
+            return;
+        if (vt_->relocate)
+            vt_->relocate(buf_, other.buf_);
+        else
+            std::memcpy(buf_, other.buf_, sizeof(buf_));
+    }
+
+    void reset_() noexcept
+    {
+        if (vt_ && vt_->destroy)
+            vt_->destroy(buf_);
+        vt_ = nullptr;
+    }
+};
+
+static_assert(sizeof(DynError) == 4 * sizeof(void *));
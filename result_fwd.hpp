@@ -0,0 +1,18 @@
+#pragma once
+
+// Declarations only, for headers that name Result in function signatures,
+// members held by pointer or friend declarations. Functions may be declared
+// to return or take a Result< T, E > by value with just this header; the
+// translation units that call or define them include result.hpp, so the
+// class is only instantiated where it is used.
+//
+//   #include "result_fwd.hpp"
+//
+//   Result< Config, ParseError > load_config(std::string_view path);
+
+template<typename T, typename E>
+class Result;
+
+// Fused map/and_then pipeline over a Result, defined in result_lazy.hpp
+template<typename T, typename E, typename... Ops>
+class LazyResult;
@@ -0,0 +1,248 @@
+#pragma once
+
+#include "result.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+// Per-call-site error counters. With RESULT_INSTRUMENT defined before
+// result.hpp is included (in every translation unit), each Err(...) counts
+// against the location of its call and each TRY, TRY_VOID and TRY_ASSIGN
+// that propagates an Err counts against its own. result.hpp pulls this
+// header in by itself; without the macro the hooks compile to nothing and
+// the snapshot below is empty.
+//
+// Counts live in a per-thread table of RESULT_INSTRUMENT_SITES slots (a
+// power of two, 1024 by default) keyed by the location, so recording is a
+// probe of the calling thread's table and one relaxed increment that no
+// other thread writes. Locations beyond the table's capacity are counted
+// under an empty location. Snapshots merge all live threads with the totals
+// of threads that have exited.
+//
+//   for (auto const& site : error_site_counts())
+//       log(site.location.file, site.location.line, site.count);
+
+#if !defined(RESULT_INSTRUMENT_SITES)
+#define RESULT_INSTRUMENT_SITES 1024
+#endif
+
+enum class ErrorEvent : unsigned char { created, propagated };
+
+struct ErrorSiteCount
+{
+    details::SourceLocation location;
+    ErrorEvent event;
+    std::uint64_t count;
+};
+
+namespace details {
+
+class ErrorSiteShard;
+
+class ErrorSiteRegistry
+{
+    std::mutex mutex_;
+    std::vector< ErrorSiteShard * > shards_;
+    std::vector< ErrorSiteCount > retired_;
+
+    friend class ErrorSiteShard;
+
+public:
+    static ErrorSiteRegistry & instance()
+    {
+        static ErrorSiteRegistry registry;
+        return registry;
+    }
+
+    inline std::vector< ErrorSiteCount > snapshot();
+};
+
+class ErrorSiteShard
+{
+    static constexpr std::size_t capacity = RESULT_INSTRUMENT_SITES;
+    static_assert(capacity != 0 && (capacity & (capacity - 1)) == 0,
+        "RESULT_INSTRUMENT_SITES must be a power of two");
+
+    // A slot is claimed by its owning thread and published by the release
+    // store of file; readers on other threads acquire it
+    struct Slot
+    {
+        std::atomic< char const * > file{ nullptr };
+        char const * function = nullptr;
+        unsigned line = 0;
+        ErrorEvent event = ErrorEvent::created;
+        std::atomic< std::uint64_t > count{ 0 };
+    };
+
+    std::unique_ptr< Slot[] > slots_;
+    std::atomic< std::uint64_t > overflow_[2] = {};
+
+    static void bump_(std::atomic< std::uint64_t > & c) noexcept
+    {
+        c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    friend class ErrorSiteRegistry;
+
+public:
+    ErrorSiteShard() : slots_(new Slot[capacity])
+    {
+        auto& reg = ErrorSiteRegistry::instance();
+        std::lock_guard< std::mutex > lock(reg.mutex_);
+        reg.shards_.push_back(this);
+    }
+
+    ErrorSiteShard(ErrorSiteShard const&) = delete;
+    ErrorSiteShard& operator=(ErrorSiteShard const&) = delete;
+
+    ~ErrorSiteShard()
+    {
+        auto& reg = ErrorSiteRegistry::instance();
+        std::lock_guard< std::mutex > lock(reg.mutex_);
+        collect_(reg.retired_);
+        reg.shards_.erase(std::find(reg.shards_.begin(), reg.shards_.end(), this));
+    }
+
+    void hit(SourceLocation loc, ErrorEvent event) noexcept
+    {
+        std::size_t h = (reinterpret_cast< std::uintptr_t >(loc.file) >> 3)
+            ^ (std::size_t(loc.line) * 0x9E3779B1u) ^ std::size_t(event);
+        for (std::size_t i = 0; i < capacity; ++i)
+        {
+            Slot & s = slots_[(h + i) & (capacity - 1)];
+            char const * file = s.file.load(std::memory_order_relaxed);
+            if (RESULT_LIKELY(file == loc.file && s.line == loc.line && s.event == event))
+            {
+                bump_(s.count);
+                return;
+            }
+            if (!file)
+            {
+                s.function = loc.function;
+                s.line = loc.line;
+                s.event = event;
+                s.count.store(1, std::memory_order_relaxed);
+                s.file.store(loc.file, std::memory_order_release);
+                return;
+            }
+        }
+        bump_(overflow_[std::size_t(event)]);
+    }
+
+    static ErrorSiteShard & local()
+    {
+        thread_local ErrorSiteShard shard;
+        return shard;
+    }
+
+private:
+    void collect_(std::vector< ErrorSiteCount > & out) const
+    {
+        for (std::size_t i = 0; i < capacity; ++i)
+        {
+            Slot const& s = slots_[i];
+            if (char const * file = s.file.load(std::memory_order_acquire))
+                out.push_back({ SourceLocation{ file, s.function, s.line }, s.event,
+                    s.count.load(std::memory_order_relaxed) });
+        }
+        for (std::size_t e = 0; e < 2; ++e)
+            if (std::uint64_t n = overflow_[e].load(std::memory_order_relaxed))
+                out.push_back({ SourceLocation{}, ErrorEvent(e), n });
+    }
+};
+
+inline std::vector< ErrorSiteCount > ErrorSiteRegistry::snapshot()
+{
+    std::vector< ErrorSiteCount > all;
+    {
+        std::lock_guard< std::mutex > lock(mutex_);
+        all = retired_;
+        for (ErrorSiteShard const * shard : shards_)
+            shard->collect_(all);
+    }
+
+    // The same location may carry different file pointers across threads
+    // and translation units, so merge by contents
+    auto key_less = [](ErrorSiteCount const& a, ErrorSiteCount const& b)
+    {
+        if (int c = std::strcmp(a.location.file, b.location.file))
+            return c < 0;
+        if (a.location.line != b.location.line)
+            return a.location.line < b.location.line;
+        return a.event < b.event;
+    };
+    std::sort(all.begin(), all.end(), key_less);
+
+    std::vector< ErrorSiteCount > merged;
+    for (auto const& site : all)
+    {
+        if (!merged.empty() && !key_less(merged.back(), site))
+            merged.back().count += site.count;
+        else
+            merged.push_back(site);
+    }
+    std::stable_sort(merged.begin(), merged.end(),
+        [](ErrorSiteCount const& a, ErrorSiteCount const& b) { return a.count > b.count; });
+    return merged;
+}
+
+#if defined(RESULT_INSTRUMENT)
+inline void instrument_err(SourceLocation loc) noexcept
+{
+    ErrorSiteShard::local().hit(loc, ErrorEvent::created);
+}
+
+inline void instrument_try(SourceLocation loc) noexcept
+{
+    ErrorSiteShard::local().hit(loc, ErrorEvent::propagated);
+}
+#endif
+
+inline void write_prometheus_label_(std::ostream & os, std::string_view v)
+{
+    for (char c : v)
+    {
+        if (c == '\\' || c == '"')
+            os << '\\' << c;
+        else if (c == '\n')
+            os << "\\n";
+        else
+            os << c;
+    }
+}
+
+} /* namespace details */
+
+
+// Counts of every call site seen so far, most frequent first
+inline std::vector< ErrorSiteCount > error_site_counts()
+{
+    return details::ErrorSiteRegistry::instance().snapshot();
+}
+
+// Writes the counts as a Prometheus counter family in the text exposition
+// format, one series per call site and event:
+//
+//   result_errors_total{event="created",file="net.cpp",line="42",function="parse"} 17
+inline void write_error_sites_prometheus(std::ostream & os, std::string_view metric = "result_errors_total")
+{
+    os << "# HELP " << metric << " Errors created by Err or propagated by TRY, per call site.\n";
+    os << "# TYPE " << metric << " counter\n";
+    for (auto const& site : error_site_counts())
+    {
+        os << metric << "{event=\"" << (site.event == ErrorEvent::created ? "created" : "propagated")
+           << "\",file=\"";
+        details::write_prometheus_label_(os, site.location.file);
+        os << "\",line=\"" << site.location.line << "\",function=\"";
+        details::write_prometheus_label_(os, site.location.function);
+        os << "\"} " << site.count << '\n';
+    }
+}
@@ -0,0 +1,227 @@
+#pragma once
+
+#include "result.hpp"
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Fused combinator pipelines. Stages are collected into an expression
+// template and run in a single pass:
+//
+//   Result< Reply, Errc > r = parse(buf).lazy()
+//       | lazy::map(decode)
+//       | lazy::and_then(validate)
+//       | lazy::map_err(to_errc);
+//
+// The Ok payload is handed from stage to stage as a plain value, so there
+// is no intermediate Result between map stages and the discriminant is only
+// tested again after an and_then or or_else. An Err leaves the Ok track
+// once and runs only the error stages after it. Types and semantics are
+// those of the eager map, map_err, and_then and or_else.
+
+namespace details {
+
+enum class LazyKind { map, map_err, and_then, or_else };
+
+} /* namespace details */
+
+namespace lazy {
+
+template<typename Fn>
+struct Map { static constexpr details::LazyKind kind = details::LazyKind::map; Fn fn; };
+
+template<typename Fn>
+struct MapErr { static constexpr details::LazyKind kind = details::LazyKind::map_err; Fn fn; };
+
+template<typename Fn>
+struct AndThen { static constexpr details::LazyKind kind = details::LazyKind::and_then; Fn fn; };
+
+template<typename Fn>
+struct OrElse { static constexpr details::LazyKind kind = details::LazyKind::or_else; Fn fn; };
+
+template<typename Fn>
+constexpr Map< std::decay_t< Fn > > map(Fn&& fn) { return { std::forward< Fn >(fn) }; }
+
+template<typename Fn>
+constexpr MapErr< std::decay_t< Fn > > map_err(Fn&& fn) { return { std::forward< Fn >(fn) }; }
+
+template<typename Fn>
+constexpr AndThen< std::decay_t< Fn > > and_then(Fn&& fn) { return { std::forward< Fn >(fn) }; }
+
+template<typename Fn>
+constexpr OrElse< std::decay_t< Fn > > or_else(Fn&& fn) { return { std::forward< Fn >(fn) }; }
+
+} /* namespace lazy */
+
+namespace details {
+
+// Result type after applying stage Op eagerly to an rvalue Cur
+template<typename Cur, typename Op>
+struct lazy_next;
+
+template<typename Cur, typename Fn>
+struct lazy_next< Cur, lazy::Map< Fn > >
+{ using type = decltype(std::declval< Cur >().map(std::declval< Fn& >())); };
+
+template<typename Cur, typename Fn>
+struct lazy_next< Cur, lazy::MapErr< Fn > >
+{ using type = decltype(std::declval< Cur >().map_err(std::declval< Fn& >())); };
+
+template<typename Cur, typename Fn>
+struct lazy_next< Cur, lazy::AndThen< Fn > >
+{ using type = decltype(std::declval< Cur >().and_then(std::declval< Fn& >())); };
+
+template<typename Cur, typename Fn>
+struct lazy_next< Cur, lazy::OrElse< Fn > >
+{ using type = decltype(std::declval< Cur >().or_else(std::declval< Fn& >())); };
+
+template<typename Cur, typename Op>
+using lazy_next_t = typename lazy_next< Cur, Op >::type;
+
+template<typename Cur, typename... Ops>
+struct lazy_fold { using type = Cur; };
+
+template<typename Cur, typename Op, typename... Ops>
+struct lazy_fold< Cur, Op, Ops... > { using type = typename lazy_fold< lazy_next_t< Cur, Op >, Ops... >::type; };
+
+// fn called with payload a, or with nothing when payload type A is void
+template<typename A, typename Fn, typename V>
+constexpr decltype(auto) lazy_call(Fn & fn, V&& v)
+{
+    if constexpr (std::is_void_v< A >)
+        return details::invoke(fn);
+    else
+        return details::invoke(fn, std::forward< V >(v));
+}
+
+} /* namespace details */
+
+
+template<typename T, typename E, typename... Ops>
+class LazyResult
+{
+    using Src = Result< T, E >;
+
+    Src src_;
+    std::tuple< Ops... > ops_;
+
+    constexpr LazyResult(Src&& src, std::tuple< Ops... >&& ops)
+        : src_(std::move(src)), ops_(std::move(ops)) {}
+
+    template<typename U, typename F, typename... Os>
+    friend class LazyResult;
+
+public:
+    using result_type = typename details::lazy_fold< Src, Ops... >::type;
+
+    constexpr explicit LazyResult(Src src) : src_(std::move(src)) {}
+
+    template<typename Op>
+    constexpr LazyResult< T, E, Ops..., Op > operator|(Op op) &&
+    {
+        return LazyResult< T, E, Ops..., Op >(std::move(src_),
+            std::tuple_cat(std::move(ops_), std::tuple< Op >(std::move(op))));
+    }
+
+    constexpr result_type eval() &&
+    {
+        if (src_.is_ok())
+            return ok_< 0, Src >(ok_value_(src_));
+        return err_< 0, Src >(details::TryAccess::take_err(src_));
+    }
+
+    constexpr operator result_type() && { return std::move(*this).eval(); }
+
+private:
+    static constexpr std::size_t n_ = sizeof...(Ops);
+
+    template<typename Res>
+    static constexpr decltype(auto) ok_value_(Res & res)
+    {
+        if constexpr (std::is_void_v< typename Res::value_type >)
+            return details::Unit{};
+        else
+            return details::TryAccess::take_ok(res);
+    }
+
+    // Stage I on the Ok track, with v the Ok payload of a Cur
+    template<std::size_t I, typename Cur, typename V>
+    constexpr result_type ok_(V&& v)
+    {
+        using A = typename Cur::value_type;
+        if constexpr (I == n_)
+        {
+            if constexpr (std::is_void_v< A >)
+                return result_type(in_place_ok);
+            else
+                return result_type(in_place_ok, std::forward< V >(v));
+        }
+        else
+        {
+            using Op = std::tuple_element_t< I, std::tuple< Ops... > >;
+            using Next = details::lazy_next_t< Cur, Op >;
+            auto& fn = std::get< I >(ops_).fn;
+
+            if constexpr (Op::kind == details::LazyKind::map)
+            {
+                if constexpr (std::is_void_v< typename Next::value_type >)
+                    return details::lazy_call< A >(fn, std::forward< V >(v)), ok_< I + 1, Next >(details::Unit{});
+                else
+                    return ok_< I + 1, Next >(details::lazy_call< A >(fn, std::forward< V >(v)));
+            }
+            else if constexpr (Op::kind == details::LazyKind::and_then)
+            {
+                Next res = details::lazy_call< A >(fn, std::forward< V >(v));
+                if (RESULT_UNLIKELY(res.is_err()))
+                    return err_< I + 1, Next >(details::TryAccess::take_err(res));
+                return ok_< I + 1, Next >(ok_value_(res));
+            }
+            else
+            {
+                return ok_< I + 1, Next >(std::forward< V >(v));
+            }
+        }
+    }
+
+    // Stage I on the Err track, with err the Err of a Cur. The error stays
+    // wrapped so that it keeps its return trace in RESULT_TRACE builds.
+    template<std::size_t I, typename Cur, typename G>
+    constexpr result_type err_(details::Err< G >&& err)
+    {
+        using A = typename Cur::error_type;
+        if constexpr (I == n_)
+        {
+            return result_type(std::move(err));
+        }
+        else
+        {
+            using Op = std::tuple_element_t< I, std::tuple< Ops... > >;
+            using Next = details::lazy_next_t< Cur, Op >;
+            using F = details::value_t< typename Next::error_type >;
+            auto& fn = std::get< I >(ops_).fn;
+
+            if constexpr (Op::kind == details::LazyKind::map_err)
+            {
+                if constexpr (std::is_void_v< typename Next::error_type >)
+                    return details::lazy_call< A >(fn, std::move(err.e_)),
+                        err_< I + 1, Next >(details::rewrap_err< F >(err, details::Unit{}));
+                else
+                    return err_< I + 1, Next >(
+                        details::rewrap_err< F >(err, details::lazy_call< A >(fn, std::move(err.e_))));
+            }
+            else if constexpr (Op::kind == details::LazyKind::or_else)
+            {
+                Next res = details::lazy_call< A >(fn, std::move(err.e_));
+                if (res.is_ok())
+                    return ok_< I + 1, Next >(ok_value_(res));
+                return err_< I + 1, Next >(details::TryAccess::take_err(res));
+            }
+            else
+            {
+                return err_< I + 1, Next >(std::move(err));
+            }
+        }
+    }
+};
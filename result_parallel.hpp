@@ -0,0 +1,264 @@
+#pragma once
+
+#include "result_algorithm.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Execution policies for try_transform. These are the library's own tags
+// rather than std::execution's: with libstdc++, including <execution> makes
+// every translation unit built without optimization link against TBB.
+namespace result_execution {
+
+struct sequenced_policy {};
+struct parallel_policy {};
+
+inline constexpr sequenced_policy seq{};
+inline constexpr parallel_policy par{};
+
+} /* namespace result_execution */
+
+namespace details {
+
+template<typename Policy>
+constexpr bool is_parallel_policy_v = std::is_same_v< Policy, result_execution::parallel_policy >;
+
+template<typename Policy>
+constexpr bool is_execution_policy_v =
+    is_parallel_policy_v< Policy > || std::is_same_v< Policy, result_execution::sequenced_policy >;
+
+// Fewest elements handed to a worker at a time; inputs of a single chunk are
+// transformed on the calling thread, since waking a worker costs more
+inline constexpr std::size_t parallel_min_chunk = 1024;
+
+// Worker threads shared by every parallel call, started on first use and
+// joined at exit. A thread that waits for its own tasks runs queued ones
+// meanwhile, so nested parallel calls cannot starve each other.
+class ThreadPool
+{
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::deque< std::function< void() > > tasks_;
+    std::vector< std::thread > threads_;
+    bool stop_ = false;
+
+    void run_()
+    {
+        for (;;)
+        {
+            std::function< void() > task;
+            {
+                std::unique_lock< std::mutex > lock(mutex_);
+                wake_.wait(lock, [&] { return stop_ || !tasks_.empty(); });
+                if (tasks_.empty())
+                    return;
+                task = std::move(tasks_.front());
+                tasks_.pop_front();
+            }
+            task();
+        }
+    }
+
+public:
+    explicit ThreadPool(std::size_t threads)
+    {
+        threads_.reserve(threads);
+        for (std::size_t i = 0; i < threads; ++i)
+            threads_.emplace_back([this] { run_(); });
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard< std::mutex > lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (auto& t : threads_)
+            t.join();
+    }
+
+    ThreadPool(ThreadPool const&) = delete;
+    ThreadPool& operator=(ThreadPool const&) = delete;
+
+    std::size_t size() const noexcept { return threads_.size(); }
+
+    void post(std::function< void() > task)
+    {
+        {
+            std::lock_guard< std::mutex > lock(mutex_);
+            tasks_.push_back(std::move(task));
+        }
+        wake_.notify_one();
+    }
+
+    // Runs one queued task on the calling thread, if there is one
+    bool run_one()
+    {
+        std::function< void() > task;
+        {
+            std::lock_guard< std::mutex > lock(mutex_);
+            if (tasks_.empty())
+                return false;
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+        task();
+        return true;
+    }
+
+    // The calling thread works too, so one fewer than the hardware threads
+    static ThreadPool & shared()
+    {
+        static ThreadPool pool(std::max< unsigned >(1, std::thread::hardware_concurrency()) - 1);
+        return pool;
+    }
+};
+
+// Counts the posted tasks of one call down to zero
+class TaskLatch
+{
+    std::mutex mutex_;
+    std::condition_variable done_;
+    std::size_t count_;
+
+public:
+    explicit TaskLatch(std::size_t count) : count_(count) {}
+
+    void count_down()
+    {
+        std::lock_guard< std::mutex > lock(mutex_);
+        if (--count_ == 0)
+            done_.notify_all();
+    }
+
+    void wait()
+    {
+        std::unique_lock< std::mutex > lock(mutex_);
+        done_.wait(lock, [&] { return count_ == 0; });
+    }
+};
+
+// Lowers *slot to index unless it already holds a smaller one
+inline void atomic_min(std::atomic< std::size_t > & slot, std::size_t index)
+{
+    std::size_t cur = slot.load(std::memory_order_relaxed);
+    while (index < cur && !slot.compare_exchange_weak(cur, index, std::memory_order_relaxed))
+        ;
+}
+
+} /* namespace details */
+
+
+// try_transform over a random-access range, run on the shared worker
+// threads when the policy is result_execution::par. Workers claim chunks in
+// index order and stop claiming as soon as an Err is recorded before them,
+// so the result is deterministic: every Ok value in order, or the error of
+// the lowest failing index. Ranges of no more than one chunk run the serial
+// try_transform instead. As with the standard parallel algorithms, an
+// exception escaping fn during a parallel run calls std::terminate.
+template<typename Container = void, typename Policy, typename Range, typename Fn,
+    typename = std::enable_if_t< details::is_execution_policy_v< std::decay_t< Policy > > > >
+auto try_transform(Policy&&, Range&& range, Fn&& fn)
+{
+    if constexpr (!details::is_parallel_policy_v< std::decay_t< Policy > >)
+    {
+        return try_transform< Container >(std::forward< Range >(range), std::forward< Fn >(fn));
+    }
+    else
+    {
+        using Iter = decltype(std::begin(std::declval< Range& >()));
+        static_assert(std::is_base_of_v< std::random_access_iterator_tag,
+            typename std::iterator_traits< Iter >::iterator_category >,
+            "Parallel try_transform needs a random-access range");
+        static_assert(details::has_size< Range >::value,
+            "Parallel try_transform needs a sized range");
+
+        using ResFn = std::decay_t< std::invoke_result_t< Fn&,
+            decltype(details::forward_elem< Range >(*std::begin(range))) > >;
+        static_assert(details::is_result_v< ResFn >,
+            "Function is not of signature Fn(Elem) -> Result<U, E>");
+        using U = typename ResFn::value_type;
+        using E = typename ResFn::error_type;
+        using C = std::conditional_t< std::is_void_v< Container >, std::vector< U >, Container >;
+        using ResOut = Result< C, E >;
+
+        std::size_t const n = static_cast< std::size_t >(std::size(range));
+        auto& pool = details::ThreadPool::shared();
+        std::size_t const workers = pool.size() + 1;
+        std::size_t const chunk = std::max(details::parallel_min_chunk, n / (workers * 8));
+        if (n <= chunk)
+            return try_transform< Container >(std::forward< Range >(range), std::forward< Fn >(fn));
+
+        auto first = std::begin(range);
+
+        std::vector< std::optional< U > > values(n);
+        // The failing Results themselves, so errors keep their return trace
+        std::vector< std::optional< std::pair< std::size_t, ResFn > > > errors(workers);
+        std::atomic< std::size_t > next{ 0 };
+        std::atomic< std::size_t > first_err{ n };
+
+        auto work = [&](std::size_t w) noexcept
+        {
+            for (;;)
+            {
+                std::size_t start = next.fetch_add(chunk, std::memory_order_relaxed);
+                if (start >= n || start > first_err.load(std::memory_order_relaxed))
+                    return;
+                std::size_t end = std::min(n, start + chunk);
+                for (std::size_t i = start; i < end; ++i)
+                {
+                    if (i > first_err.load(std::memory_order_relaxed))
+                        return;
+                    ResFn res = details::invoke(fn, details::forward_elem< Range >(first[i]));
+                    if (RESULT_UNLIKELY(res.is_err()))
+                    {
+                        if (!errors[w] || i < errors[w]->first)
+                            errors[w].emplace(i, std::move(res));
+                        details::atomic_min(first_err, i);
+                        return;
+                    }
+                    values[i].emplace(std::move(res).unwrap());
+                }
+            }
+        };
+
+        std::size_t const spawned = std::min(workers, (n + chunk - 1) / chunk);
+        details::TaskLatch latch(spawned - 1);
+        for (std::size_t w = 1; w < spawned; ++w)
+            pool.post([&work, &latch, w]
+            {
+                work(w);
+                latch.count_down();
+            });
+        work(0);
+        while (pool.run_one())
+            ;
+        latch.wait();
+
+        std::size_t const failed = first_err.load(std::memory_order_relaxed);
+        if (failed < n)
+        {
+            for (auto& err : errors)
+                if (err && err->first == failed)
+                    return ResOut(details::TryAccess::take_err(err->second));
+        }
+
+        C out;
+        details::reserve_for(out, values);
+        for (auto& v : values)
+            out.push_back(std::move(*v));
+        return ResOut(in_place_ok, std::move(out));
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "result.hpp"
+
+#include <cstddef>
+#include <memory_resource>
+#include <utility>
+
+// Results whose payloads live in a std::pmr::memory_resource. Result takes
+// part in uses-allocator construction: std::uses_allocator is true when T or
+// E uses the allocator, and the std::allocator_arg_t constructors hand it to
+// the active payload. A pmr container of Results therefore builds payloads
+// in its own resource, and the factories below do the same for a single
+// Result:
+//
+//   std::pmr::monotonic_buffer_resource arena;
+//   auto r = result_pmr::make_ok< std::pmr::string, Errc >(&arena, "hello");
+//   std::pmr::vector< Result< std::pmr::string, Errc > > v(&arena);
+//   v.push_back(std::move(r));                 // payload stays in arena
+//
+// Dropping the arena then frees every payload at once, as long as the
+// Results themselves are not used afterwards.
+
+namespace result_pmr {
+
+using allocator_type = std::pmr::polymorphic_allocator< std::byte >;
+
+// Result< T, E > holding a T built from args with mr
+template<typename T, typename E, typename... Args>
+Result< T, E > make_ok(std::pmr::memory_resource * mr, Args&&... args)
+{
+    return Result< T, E >(std::allocator_arg, allocator_type(mr), in_place_ok, std::forward< Args >(args)...);
+}
+
+// Result< T, E > holding an E built from args with mr
+template<typename T, typename E, typename... Args>
+Result< T, E > make_err(std::pmr::memory_resource * mr, Args&&... args)
+{
+    return Result< T, E >(std::allocator_arg, allocator_type(mr), in_place_err, std::forward< Args >(args)...);
+}
+
+// Copy of res whose payload is rebuilt with mr
+template<typename T, typename E>
+Result< T, E > rebind(std::pmr::memory_resource * mr, Result< T, E > const& res)
+{
+    return Result< T, E >(std::allocator_arg, allocator_type(mr), res);
+}
+
+template<typename T, typename E>
+Result< T, E > rebind(std::pmr::memory_resource * mr, Result< T, E >&& res)
+{
+    return Result< T, E >(std::allocator_arg, allocator_type(mr), std::move(res));
+}
+
+} /* namespace result_pmr */
@@ -0,0 +1,305 @@
+#pragma once
+
+#include "result.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(__has_include)
+#if __has_include(<sys/uio.h>)
+#include <sys/uio.h>
+#define RESULT_WIRE_HAS_IOVEC 1
+#endif
+#endif
+
+// Binary encoding of a Result for shared memory and sockets. Every encoded
+// Result is a 16-byte header followed by the payload of the active side:
+//
+//   offset  size  field
+//        0     4  tag       1 = Ok, 2 = Err
+//        4     4  reserved  0
+//        8     8  length    payload bytes that follow
+//       16     *  payload
+//
+// Integers are in host byte order, so both ends must share endianness and
+// the payload's ABI. A void side has a length of 0.
+//
+// For trivially copyable payloads WireResult< T, E > is that layout as a
+// fixed-size struct, which can be memcpy'd or placed straight into a
+// shared-memory ring; the payload is the object representation. Other
+// payloads are written as scatter/gather segments described by
+// wire_segments< T >. On the receiving side wire_view() validates a buffer
+// and reads it in place.
+
+struct WireHeader
+{
+    std::uint32_t tag;
+    std::uint32_t reserved;
+    std::uint64_t length;
+};
+
+static_assert(sizeof(WireHeader) == 16 && std::is_trivially_copyable_v< WireHeader >);
+
+namespace details {
+
+constexpr std::uint32_t wire_ok = 1;
+constexpr std::uint32_t wire_err = 2;
+constexpr std::size_t wire_payload_offset = sizeof(WireHeader);
+
+template<typename A>
+constexpr std::size_t wire_size_v = std::is_void_v< A > ? 0 : sizeof(value_t< A >);
+
+template<typename A>
+constexpr bool wire_trivial_v = std::is_void_v< A > ||
+    (!std::is_reference_v< A > && std::is_trivially_copyable_v< A >);
+
+template<typename A>
+constexpr bool wire_unique_v = std::is_void_v< A > || std::has_unique_object_representations_v< A >;
+
+} /* namespace details */
+
+
+// Fixed-size encoding of a Result of trivially copyable payloads. The
+// header and the payload bytes after the active side are zero. The payload
+// itself is copied as its object representation, internal padding
+// included, so only when unique_representation holds do encodings of equal
+// Results compare equal bytewise with nothing of the sender's memory in
+// them.
+template<typename T, typename E>
+struct WireResult
+{
+    static_assert(details::wire_trivial_v< T > && details::wire_trivial_v< E >,
+        "WireResult needs trivially copyable payloads; use wire_segments for others");
+    static_assert(alignof(details::value_t< T >) <= 16 && alignof(details::value_t< E >) <= 16,
+        "WireResult payloads may be aligned to at most 16 bytes");
+
+    static constexpr std::size_t payload_capacity =
+        details::wire_size_v< T > < details::wire_size_v< E > ? details::wire_size_v< E > : details::wire_size_v< T >;
+
+    // Neither payload has padding bits, and equal values have equal bytes
+    static constexpr bool unique_representation =
+        details::wire_unique_v< T > && details::wire_unique_v< E >;
+
+    WireHeader header;
+    alignas(16) unsigned char payload[payload_capacity ? payload_capacity : 1];
+
+    static WireResult encode(Result< T, E > const& res)
+    {
+        WireResult w;
+        std::memset(&w, 0, sizeof(w));
+        if (res.is_ok())
+        {
+            w.header.tag = details::wire_ok;
+            w.header.length = details::wire_size_v< T >;
+            if constexpr (!std::is_void_v< T >)
+                std::memcpy(w.payload, res.value_ptr(), sizeof(T));
+        }
+        else
+        {
+            w.header.tag = details::wire_err;
+            w.header.length = details::wire_size_v< E >;
+            if constexpr (!std::is_void_v< E >)
+                std::memcpy(w.payload, res.error_ptr(), sizeof(E));
+        }
+        return w;
+    }
+};
+
+
+// Customization point describing a payload as byte segments for
+// scatter/gather output. A specialization provides
+//
+//   static std::size_t count(T const& t);                // segments for t
+//   static void fill(T const& t, WireSegment * out);     // writes count(t) of them
+//
+// Trivially copyable types are one segment of their object representation;
+// std::string and vectors of trivially copyable elements are their contents.
+struct WireSegment
+{
+    void const * data;
+    std::size_t size;
+};
+
+#if defined(RESULT_WIRE_HAS_IOVEC)
+// An array of WireSegment may be handed to writev as iovec
+static_assert(sizeof(WireSegment) == sizeof(iovec) &&
+    offsetof(WireSegment, data) == offsetof(iovec, iov_base) &&
+    offsetof(WireSegment, size) == offsetof(iovec, iov_len));
+#endif
+
+template<typename T, typename = void>
+struct wire_segments;
+
+template<typename T>
+struct wire_segments< T, std::enable_if_t< std::is_trivially_copyable_v< T > > >
+{
+    static std::size_t count(T const&) { return 1; }
+    static void fill(T const& t, WireSegment * out) { *out = { std::addressof(t), sizeof(T) }; }
+};
+
+template<>
+struct wire_segments< std::string >
+{
+    static std::size_t count(std::string const&) { return 1; }
+    static void fill(std::string const& s, WireSegment * out) { *out = { s.data(), s.size() }; }
+};
+
+template<typename U, typename Alloc>
+struct wire_segments< std::vector< U, Alloc >, std::enable_if_t< std::is_trivially_copyable_v< U > > >
+{
+    static std::size_t count(std::vector< U, Alloc > const&) { return 1; }
+    static void fill(std::vector< U, Alloc > const& v, WireSegment * out) { *out = { v.data(), v.size() * sizeof(U) }; }
+};
+
+// Segments wire_gather writes for res: the header and the payload's
+template<typename T, typename E>
+std::size_t wire_segment_count(Result< T, E > const& res)
+{
+    if (res.is_ok())
+    {
+        if constexpr (std::is_void_v< T >)
+            return 1;
+        else
+            return 1 + wire_segments< std::decay_t< T > >::count(*res.value_ptr());
+    }
+    if constexpr (std::is_void_v< E >)
+        return 1;
+    else
+        return 1 + wire_segments< std::decay_t< E > >::count(*res.error_ptr());
+}
+
+// Fills header and out with the encoding of res, returning the number of
+// segments written, or 0 if max is less than wire_segment_count(res). out[0]
+// points at header, which must outlive the write; the other segments point
+// into the payload of res.
+template<typename T, typename E>
+std::size_t wire_gather(Result< T, E > const& res, WireHeader & header, WireSegment * out, std::size_t max)
+{
+    std::size_t const n = wire_segment_count(res);
+    if (n > max)
+        return 0;
+
+    header = WireHeader{ res.is_ok() ? details::wire_ok : details::wire_err, 0, 0 };
+    out[0] = { &header, sizeof(header) };
+    if (n > 1)
+    {
+        if (res.is_ok())
+        {
+            if constexpr (!std::is_void_v< T >)
+                wire_segments< std::decay_t< T > >::fill(*res.value_ptr(), out + 1);
+        }
+        else
+        {
+            if constexpr (!std::is_void_v< E >)
+                wire_segments< std::decay_t< E > >::fill(*res.error_ptr(), out + 1);
+        }
+        for (std::size_t i = 1; i < n; ++i)
+            header.length += out[i].size;
+    }
+    return n;
+}
+
+
+enum class WireErrc
+{
+    truncated,    // shorter than the header or the length it announces
+    bad_header,   // unknown tag or reserved bits set
+    bad_length,   // length differs from the size of a trivially copyable payload
+};
+
+// Validated, non-owning view of an encoded Result in a received buffer.
+// Trivially copyable payloads are read in place when the buffer is
+// suitably aligned and copied out otherwise; the payload bytes of any
+// other type are available for it to decode.
+template<typename T, typename E>
+class WireView
+{
+    unsigned char const * data_;
+    WireHeader header_;
+
+    WireView(unsigned char const * data, WireHeader header) : data_(data), header_(header) {}
+
+    template<typename U, typename F>
+    friend Result< WireView< U, F >, WireErrc > wire_view(void const * data, std::size_t size);
+
+    template<typename A>
+    A const * ptr_() const
+    {
+        void const * p = data_ + details::wire_payload_offset;
+        return reinterpret_cast< std::uintptr_t >(p) % alignof(A) == 0
+            ? std::launder(reinterpret_cast< A const * >(p)) : nullptr;
+    }
+
+    template<typename A>
+    A load_() const
+    {
+        // memcpy into suitably aligned storage starts the lifetime of an A
+        alignas(A) unsigned char buf[sizeof(A)];
+        std::memcpy(buf, data_ + details::wire_payload_offset, sizeof(A));
+        return *std::launder(reinterpret_cast< A * >(buf));
+    }
+
+public:
+    bool is_ok() const { return header_.tag == details::wire_ok; }
+    bool is_err() const { return header_.tag == details::wire_err; }
+
+    // Payload bytes of the active side
+    unsigned char const * payload() const { return data_ + details::wire_payload_offset; }
+    std::size_t payload_size() const { return std::size_t(header_.length); }
+
+    // The payload in place; nullptr for the other side or a misaligned buffer
+    template<typename U = T, typename = std::enable_if_t< details::wire_trivial_v< U > && !std::is_void_v< U > > >
+    U const * value_ptr() const { return is_ok() ? ptr_< U >() : nullptr; }
+
+    template<typename F = E, typename = std::enable_if_t< details::wire_trivial_v< F > && !std::is_void_v< F > > >
+    F const * error_ptr() const { return is_err() ? ptr_< F >() : nullptr; }
+
+    // Copy of the encoded Result, for trivially copyable payloads
+    Result< T, E > load() const
+    {
+        static_assert(details::wire_trivial_v< T > && details::wire_trivial_v< E >,
+            "load needs trivially copyable payloads; decode payload() instead");
+        if (is_ok())
+        {
+            if constexpr (std::is_void_v< T >)
+                return Result< T, E >(in_place_ok);
+            else
+                return Result< T, E >(in_place_ok, load_< T >());
+        }
+        if constexpr (std::is_void_v< E >)
+            return Result< T, E >(in_place_err);
+        else
+            return Result< T, E >(in_place_err, load_< E >());
+    }
+};
+
+// Checks that data holds a complete encoding of a Result< T, E > and views
+// it. For trivially copyable payloads the length must match their size
+// exactly; the payload's own invariants (enum ranges, bools) are for the
+// reader to check.
+template<typename T, typename E>
+Result< WireView< T, E >, WireErrc > wire_view(void const * data, std::size_t size)
+{
+    if (RESULT_UNLIKELY(size < sizeof(WireHeader)))
+        return Err(WireErrc::truncated);
+
+    WireHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (RESULT_UNLIKELY((header.tag != details::wire_ok && header.tag != details::wire_err) || header.reserved != 0))
+        return Err(WireErrc::bad_header);
+    if (RESULT_UNLIKELY(header.length > size - sizeof(WireHeader)))
+        return Err(WireErrc::truncated);
+
+    bool const ok = header.tag == details::wire_ok;
+    bool const fixed = ok ? details::wire_trivial_v< T > : details::wire_trivial_v< E >;
+    std::size_t const expected = ok ? details::wire_size_v< T > : details::wire_size_v< E >;
+    if (RESULT_UNLIKELY(fixed && header.length != expected))
+        return Err(WireErrc::bad_length);
+
+    return Ok(WireView< T, E >(static_cast< unsigned char const * >(data), header));
+}
@@ -0,0 +1,134 @@
+#include "result_algorithm.hpp"
+#include "result_parallel.hpp"
+
+#include "check.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+enum class Errc { negative };
+
+Result< int, Errc > checked(int x)
+{
+    if (x < 0)
+        return Err(Errc::negative);
+    return Ok(x);
+}
+
+void test_collect()
+{
+    std::vector< Result< int, Errc > > all = { Ok(1), Ok(2), Ok(3) };
+    CHECK(collect(all).unwrap() == std::vector< int >{ 1, 2, 3 });
+
+    std::vector< Result< int, Errc > > some = { Ok(1), Err(Errc::negative), Ok(3) };
+    CHECK(collect(some).unwrap_err() == Errc::negative);
+
+    std::list< Result< std::string, Errc > > strs = { Ok(std::string("a")), Ok(std::string("b")) };
+    auto moved = collect< std::list< std::string > >(std::move(strs));
+    CHECK(moved.unwrap() == std::list< std::string >{ "a", "b" });
+    CHECK(sequence(all).is_ok());
+}
+
+void test_try_fold()
+{
+    std::vector< int > xs = { 1, 2, 3, 4 };
+    auto sum = try_fold(xs, 0, [](int acc, int x) { return checked(x).map([&](int v) { return acc + v; }); });
+    CHECK(sum.unwrap() == 10);
+
+    xs[2] = -1;
+    int calls = 0;
+    auto failed = try_fold(xs, 0, [&](int acc, int x)
+    {
+        ++calls;
+        return checked(x).map([&](int v) { return acc + v; });
+    });
+    CHECK(failed.unwrap_err() == Errc::negative && calls == 3);
+}
+
+void test_try_transform()
+{
+    std::vector< int > xs = { 1, 2, 3 };
+    CHECK(try_transform(xs, checked).unwrap() == xs);
+    xs.push_back(-4);
+    CHECK(try_transform(xs, checked).unwrap_err() == Errc::negative);
+}
+
+void test_parallel()
+{
+    std::vector< int > xs(10000);
+    for (int i = 0; i < int(xs.size()); ++i)
+        xs[i] = i;
+    auto ok = try_transform(result_execution::par, xs, [](int x) { return checked(x).map([](int v) { return v * 2; }); });
+    CHECK(ok.is_ok() && ok.unwrap().size() == xs.size() && ok.unwrap()[9999] == 19998);
+
+    // The lowest failing index wins, whichever thread sees it first
+    xs[7000] = -1;
+    xs[200] = -2;
+    std::atomic< int > calls{ 0 };
+    auto err = try_transform(result_execution::par, xs, [&](int x) -> Result< int, int >
+    {
+        calls.fetch_add(1, std::memory_order_relaxed);
+        if (x < 0)
+            return Err(x);
+        return Ok(x);
+    });
+    CHECK(err.unwrap_err() == -2);
+
+    auto seq = try_transform(result_execution::seq, xs, checked);
+    CHECK(seq.unwrap_err() == Errc::negative);
+
+    // Small inputs are not worth a thread
+    std::vector< int > few = { 1, 2, 3 };
+    auto const caller = std::this_thread::get_id();
+    bool elsewhere = false;
+    auto small = try_transform(result_execution::par, few, [&](int x)
+    {
+        elsewhere = elsewhere || std::this_thread::get_id() != caller;
+        return checked(x);
+    });
+    CHECK(small.unwrap() == few && !elsewhere);
+
+    // Repeated calls run on the same threads rather than starting new ones
+    std::mutex mutex;
+    std::set< std::thread::id > ids;
+    for (int round = 0; round < 20; ++round)
+    {
+        auto res = try_transform(result_execution::par, xs, [&](int x) -> Result< int, int >
+        {
+            std::lock_guard< std::mutex > lock(mutex);
+            ids.insert(std::this_thread::get_id());
+            return Ok(x);
+        });
+        CHECK(res.is_ok());
+    }
+    CHECK(ids.size() <= std::max(1u, std::thread::hardware_concurrency()));
+
+    // A parallel call from inside another one does not deadlock
+    auto nested = try_transform(result_execution::par, xs, [&](int x) -> Result< int, int >
+    {
+        if (x % 1000 != 0)
+            return Ok(x);
+        return try_transform(result_execution::par, xs, checked)
+            .map([](std::vector< int > const& v) { return int(v.size()); })
+            .map_err([](Errc) { return -1; });
+    });
+    CHECK(nested.unwrap_err() == -1);
+}
+
+} /* namespace */
+
+int main()
+{
+    test_collect();
+    test_try_fold();
+    test_try_transform();
+    test_parallel();
+}
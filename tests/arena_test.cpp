@@ -0,0 +1,69 @@
+#include "result_arena.hpp"
+
+#include "check.hpp"
+
+#include <string>
+#include <string_view>
+
+namespace {
+
+Result< int, ErrorRef > parse(ErrorArena & arena, int x)
+{
+    if (x < 0)
+        return Err(arena.make_static("negative"));
+    return Ok(x);
+}
+
+void test_chain()
+{
+    ErrorArena arena(64);
+    auto r = parse(arena, -1).map_err([&](ErrorRef e) { return arena.make("while loading", e); });
+    ErrorRef e = r.unwrap_err();
+    CHECK(e.message() == "while loading");
+    CHECK(e.has_cause() && e.cause().message() == "negative");
+    CHECK(e.root_cause() == e.cause());
+    CHECK(!e.cause().has_cause());
+    CHECK(e.location().line != 0);
+}
+
+void test_copy_and_reset()
+{
+    ErrorArena arena(32);
+    std::string msg(100, 'x');
+    ErrorRef big = arena.make(msg);
+    msg.assign(100, 'y');
+    CHECK(big.message() == std::string(100, 'x'));
+
+    for (int round = 0; round < 3; ++round)
+    {
+        arena.reset();
+        for (int i = 0; i < 20; ++i)
+            CHECK(arena.make("n").message() == "n");
+    }
+}
+
+void test_context()
+{
+    ErrorArena arena;
+    auto r = parse(arena, -1).context("reading config");
+    CHECK(r.unwrap_err().message() == "reading config");
+    CHECK(r.unwrap_err().cause().message() == "negative");
+
+    // Context goes to the error's own arena, not the thread's
+    auto f = parse(arena, -2).with_context([] { return std::string("formatted ") + "message"; });
+    CHECK(&f.unwrap_err().arena() == &arena && &r.unwrap_err().arena() == &arena);
+    CHECK(f.unwrap_err().message() == "formatted message");
+
+    ErrorArena other;
+    auto g = parse(other, -1).context("in other");
+    CHECK(&g.unwrap_err().arena() == &other && &g.unwrap_err().arena() != &ErrorArena::local());
+}
+
+} /* namespace */
+
+int main()
+{
+    test_chain();
+    test_copy_and_reset();
+    test_context();
+}
@@ -0,0 +1,77 @@
+#include "result_async.hpp"
+
+#include "check.hpp"
+
+#include <functional>
+#include <optional>
+#include <string>
+#include <utility>
+
+namespace {
+
+enum class Errc { closed, timeout };
+
+// Source that completes only when fire() is called, like a socket read
+struct Pending
+{
+    std::function< void(Result< int, Errc >&&) > recv;
+
+    auto read()
+    {
+        return async_result< int, Errc >([this](auto&& r) { recv = std::forward< decltype(r) >(r); });
+    }
+
+    void fire(Result< int, Errc > res) { recv(std::move(res)); }
+};
+
+void test_ready_chain()
+{
+    std::optional< Result< std::string, Errc > > out;
+    async_ready(Result< int, Errc >(in_place_ok, 20))
+        .map([](int x) { return x + 1; })
+        .and_then([](int x) -> Result< int, Errc > { return Ok(x * 2); })
+        .map([](int x) { return std::to_string(x); })
+        .start([&](Result< std::string, Errc >&& res) { out.emplace(std::move(res)); });
+    CHECK(out && out->unwrap() == "42");
+}
+
+void test_error_skips_stages()
+{
+    int mapped = 0;
+    std::optional< Result< int, int > > out;
+    async_ready(Result< int, Errc >(in_place_err, Errc::closed))
+        .map([&](int x) { ++mapped; return x; })
+        .map_err([](Errc e) { return int(e) + 10; })
+        .start([&](Result< int, int >&& res) { out.emplace(std::move(res)); });
+    CHECK(mapped == 0 && out && out->unwrap_err() == 10);
+}
+
+void test_deferred_completion()
+{
+    Pending first, second;
+    std::optional< Result< int, Errc > > out;
+    first.read()
+        .and_then([&](int x) { return second.read().map([x](int y) { return x + y; }); })
+        .or_else([](Errc e) -> Result< int, Errc >
+        {
+            if (e == Errc::timeout)
+                return Ok(-1);
+            return Err(e);
+        })
+        .start([&](Result< int, Errc >&& res) { out.emplace(std::move(res)); });
+
+    CHECK(!out);
+    first.fire(Result< int, Errc >(in_place_ok, 1));
+    CHECK(!out);
+    second.fire(Result< int, Errc >(in_place_err, Errc::timeout));
+    CHECK(out && out->unwrap() == -1);
+}
+
+} /* namespace */
+
+int main()
+{
+    test_ready_chain();
+    test_error_skips_stages();
+    test_deferred_completion();
+}
@@ -0,0 +1,107 @@
+#include "result_batch.hpp"
+
+#include "check.hpp"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+void test_push_and_lookup()
+{
+    ResultBatch< int, std::string > b;
+    b.reserve(130);
+    for (int i = 0; i < 130; ++i)
+    {
+        if (i % 7 == 3)
+            b.push_err("row " + std::to_string(i));
+        else
+            b.push_ok(i);
+    }
+    b.push_back(Result< int, std::string >(in_place_err, "last"));
+
+    CHECK(b.size() == 131);
+    CHECK(b.count_err() == 19 + 1 && b.count_ok() == b.size() - b.count_err());
+    CHECK(b.is_ok(0) && b.is_err(3) && b.is_err(129));
+    CHECK(b[4].unwrap() == 4);
+    CHECK(b[10].unwrap_err() == "row 10");
+    CHECK(b[130].unwrap_err() == "last");
+}
+
+void test_map()
+{
+    ResultBatch< int, std::string > b;
+    b.push_ok(1);
+    b.push_err("bad");
+    b.push_ok(3);
+
+    auto doubled = b.map([](int x) { return x * 2; });
+    CHECK(doubled[0].unwrap() == 2 && doubled[2].unwrap() == 6);
+    CHECK(doubled[1].unwrap_err() == "bad");
+
+    auto described = std::move(doubled).map_err([](std::string e) { return e.size(); });
+    CHECK(described[1].unwrap_err() == 3);
+}
+
+// fn only sees Ok rows, so it may rely on their invariants
+void test_map_masked()
+{
+    ResultBatch< int, std::string > b;
+    b.push_ok(4);
+    b.push_err("bad");
+    auto q = b.map([](int x) { return 100 / x; });
+    CHECK(q[0].unwrap() == 25 && q[1].unwrap_err() == "bad");
+    CHECK(q.values()[1] == 0);
+
+    // Full, empty and mixed bitmap words
+    ResultBatch< int, std::string > wide;
+    for (int i = 1; i <= 200; ++i)
+    {
+        if (i > 64 && i <= 128)
+            wide.push_err("err");
+        else if (i > 128 && i % 3 == 0)
+            wide.push_err("err");
+        else
+            wide.push_ok(i);
+    }
+    int calls = 0;
+    auto r = wide.map([&calls](int x) { ++calls; return 1000 / x; });
+    CHECK(calls == int(wide.count_ok()));
+    CHECK(r[0].unwrap() == 1000 && r[63].unwrap() == 15 && r[64].is_err());
+    CHECK(r[129].unwrap() == 7 && r[131].is_err() && r[199].unwrap() == 5);
+
+    int dense_calls = 0;
+    auto d = wide.map_unchecked([&dense_calls](int x) { ++dense_calls; return x + 1; });
+    CHECK(dense_calls == 200 && d[64].is_err() && d.values()[64] == 1 && d[0].unwrap() == 2);
+}
+
+void test_consume()
+{
+    ResultBatch< int, int > b;
+    b.push_ok(1);
+    b.push_err(7);
+    b.push_ok(3);
+
+    CHECK(b.unwrap_or(-1) == std::vector< int >{ 1, -1, 3 });
+
+    ResultBatch< int, int > copy = b;
+    auto [values, errors] = std::move(copy).partition();
+    CHECK(values == std::vector< int >{ 1, 3 } && errors == std::vector< int >{ 7 });
+
+    CHECK(std::move(b).collect().unwrap_err() == 7);
+
+    ResultBatch< int, int > all;
+    all.push_ok(5);
+    CHECK(std::move(all).collect().unwrap() == std::vector< int >{ 5 });
+}
+
+} /* namespace */
+
+int main()
+{
+    test_push_and_lookup();
+    test_map();
+    test_map_masked();
+    test_consume();
+}
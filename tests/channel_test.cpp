@@ -0,0 +1,86 @@
+#include "result_channel.hpp"
+
+#include "check.hpp"
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+void test_single_thread()
+{
+    ResultChannel< std::unique_ptr< int >, std::string > ch(3);
+    CHECK(ch.capacity() == 4);
+    CHECK(ch.try_emplace_ok(std::make_unique< int >(1)));
+    CHECK(ch.try_emplace_err("bad"));
+    CHECK(ch.size_approx() == 2);
+
+    auto a = ch.try_pop();
+    CHECK(a && *a->unwrap() == 1);
+    auto b = ch.try_pop();
+    CHECK(b && b->unwrap_err() == "bad");
+    CHECK(!ch.try_pop());
+
+    for (int i = 0; i < 4; ++i)
+        CHECK(ch.try_emplace_ok(std::make_unique< int >(i)));
+    CHECK(!ch.try_emplace_ok(std::make_unique< int >(4)));
+}
+
+void test_spsc()
+{
+    using Res = Result< int, int >;
+    constexpr int n = 100000;
+    ResultChannel< int, int > ch(64);
+
+    std::thread producer([&]
+    {
+        std::vector< Res > batch;
+        int i = 0;
+        while (i < n)
+        {
+            if (i % 3 == 0)
+            {
+                batch.clear();
+                for (int j = i; j < n && j < i + 8; ++j)
+                    batch.push_back(j % 5 == 0 ? Res(in_place_err, j) : Res(in_place_ok, j));
+                i += int(ch.push_n(batch.begin(), batch.size()));
+            }
+            else if (i % 5 == 0 ? ch.try_emplace_err(i) : ch.try_emplace_ok(i))
+            {
+                ++i;
+            }
+        }
+    });
+
+    int expected = 0;
+    std::vector< Res > out(16, Res(in_place_ok, 0));
+    while (expected < n)
+    {
+        std::size_t got = ch.pop_n(out.begin(), out.size());
+        for (std::size_t k = 0; k < got; ++k, ++expected)
+        {
+            if (expected % 5 == 0)
+                CHECK(out[k].unwrap_err() == expected);
+            else
+                CHECK(out[k].unwrap() == expected);
+        }
+        if (auto one = got ? std::nullopt : ch.try_pop())
+        {
+            CHECK((one->is_ok() ? one->unwrap() : one->unwrap_err()) == expected);
+            ++expected;
+        }
+    }
+    producer.join();
+    CHECK(!ch.try_pop());
+}
+
+} /* namespace */
+
+int main()
+{
+    test_single_thread();
+    test_spsc();
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+
+// Assertion for the tests that stays on in release builds. Takes the
+// condition as variadic arguments so that template argument lists with
+// commas need no extra parentheses.
+#define CHECK(...) \
+    do \
+    { \
+        if (!(__VA_ARGS__)) \
+        { \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #__VA_ARGS__); \
+            std::abort(); \
+        } \
+    } while (0)
@@ -0,0 +1,80 @@
+# Checks the "expect" lines of SOURCE against the assembly in ASM.
+#
+#   cmake -DSOURCE=codegen.cpp -DASM=codegen.s -P check_codegen.cmake
+
+cmake_minimum_required(VERSION 3.16)
+
+file(STRINGS "${SOURCE}" specs REGEX "^// expect ")
+file(STRINGS "${ASM}" lines)
+
+set(failed OFF)
+foreach(spec IN LISTS specs)
+    string(REGEX REPLACE "^// expect +" "" spec "${spec}")
+    separate_arguments(words UNIX_COMMAND "${spec}")
+    list(POP_FRONT words fn)
+
+    set(found OFF)
+    set(inside OFF)
+    set(hot ON)
+    set(insns 0)
+    set(branches 0)
+    set(calls 0)
+    set(stack 0)
+    foreach(line IN LISTS lines)
+        if(NOT inside)
+            if(line STREQUAL "${fn}:")
+                set(found ON)
+                set(inside ON)
+            endif()
+            continue()
+        endif()
+
+        if(line MATCHES "^[ \t]*\\.size[ \t]+${fn},")
+            break()
+        elseif(line MATCHES "^[ \t]*\\.section[ \t]+\\.text\\.unlikely")
+            set(hot OFF)
+        elseif(line MATCHES "^[ \t]*\\.text")
+            set(hot ON)
+        elseif(hot AND line MATCHES "^[ \t]+([a-z][a-z0-9]*)([ \t]+(.*))?$")
+            set(op "${CMAKE_MATCH_1}")
+            set(arg "${CMAKE_MATCH_3}")
+            math(EXPR insns "${insns} + 1")
+            if(arg MATCHES "\\(%[re]sp")
+                math(EXPR stack "${stack} + 1")
+            endif()
+            if(op MATCHES "^call")
+                math(EXPR calls "${calls} + 1")
+            elseif(op STREQUAL "jmp")
+                if(NOT arg MATCHES "^\\.L")
+                    math(EXPR calls "${calls} + 1")
+                endif()
+            elseif(op MATCHES "^j")
+                math(EXPR branches "${branches} + 1")
+            endif()
+        endif()
+    endforeach()
+
+    if(NOT found)
+        message(SEND_ERROR "${fn}: not found in ${ASM}")
+        set(failed ON)
+        continue()
+    endif()
+
+    foreach(word IN LISTS words)
+        string(REGEX MATCH "^([a-z]+)=([0-9]+)$" kv "${word}")
+        if(NOT kv)
+            message(FATAL_ERROR "${fn}: bad bound '${word}'")
+        endif()
+        set(key "${CMAKE_MATCH_1}")
+        set(limit "${CMAKE_MATCH_2}")
+        if(${key} GREATER ${limit})
+            message(SEND_ERROR "${fn}: ${${key}} ${key}, expected at most ${limit}")
+            set(failed ON)
+        endif()
+    endforeach()
+    message(STATUS "${fn}: ${insns} insns, ${branches} branches, ${calls} calls, ${stack} stack")
+endforeach()
+
+if(failed)
+    message(FATAL_ERROR "codegen expectations not met")
+endif()
@@ -0,0 +1,96 @@
+// Hot paths whose code generation is pinned by check_codegen.cmake. The
+// file is compiled to assembly at -O2 with NDEBUG, and each "expect" line
+// bounds what the named function's hot section may contain:
+//
+//   insns     instructions, not counting code moved to .text.unlikely
+//   branches  conditional jumps
+//   calls     calls and tail calls to other functions
+//   stack     instructions accessing memory through the stack pointer
+//
+// The bounds leave some room for compiler versions; a failure means that
+// a change to the headers added a branch, a call or a spill to one of these.
+// Results of two 32-bit payloads are returned in registers, so none of
+// these may touch the stack.
+
+#define NDEBUG 1
+
+#include "result.hpp"
+#include "result_lazy.hpp"
+
+#include <cstdint>
+
+enum class Errc : std::uint32_t { bad = 1 };
+
+using R = Result< std::uint32_t, Errc >;
+
+R source(std::uint32_t x);
+
+extern "C" {
+
+// expect codegen_make_ok insns=4 branches=0 calls=0 stack=0
+R codegen_make_ok(std::uint32_t x)
+{
+    return Ok(x);
+}
+
+// expect codegen_is_ok insns=4 branches=0 calls=0 stack=0
+bool codegen_is_ok(R r)
+{
+    return r.is_ok();
+}
+
+// is_ok() followed by unwrap() tests the discriminant once
+// expect codegen_checked_unwrap insns=8 branches=1 calls=0 stack=0
+std::uint32_t codegen_checked_unwrap(R r)
+{
+    return r.is_ok() ? r.unwrap() : 0;
+}
+
+// The panic path of unwrap is out of line
+// expect codegen_unwrap insns=8 branches=1 calls=0 stack=0
+std::uint32_t codegen_unwrap(R r)
+{
+    return r.unwrap();
+}
+
+// expect codegen_unwrap_unchecked insns=2 branches=0 calls=0 stack=0
+std::uint32_t codegen_unwrap_unchecked(R r)
+{
+    return r.unwrap_unchecked();
+}
+
+// expect codegen_try insns=13 branches=1 calls=1 stack=0
+R codegen_try(std::uint32_t x)
+{
+    std::uint32_t v = TRY(source(x));
+    return Ok(v + 1);
+}
+
+// expect codegen_map_chain insns=20 branches=3 calls=0 stack=0
+R codegen_map_chain(R r)
+{
+    return r.map([](std::uint32_t x) { return x + 1; })
+        .and_then([](std::uint32_t x) -> R
+        {
+            if (x > 100)
+                return Err(Errc::bad);
+            return Ok(x);
+        })
+        .map([](std::uint32_t x) { return x * 2; });
+}
+
+// expect codegen_lazy_chain insns=18 branches=2 calls=0 stack=0
+R codegen_lazy_chain(R r)
+{
+    return std::move(r).lazy()
+        | lazy::map([](std::uint32_t x) { return x + 1; })
+        | lazy::and_then([](std::uint32_t x) -> R
+        {
+            if (x > 100)
+                return Err(Errc::bad);
+            return Ok(x);
+        })
+        | lazy::map([](std::uint32_t x) { return x * 2; });
+}
+
+} /* extern "C" */
@@ -0,0 +1,105 @@
+#include "result_coro.hpp"
+
+#include "check.hpp"
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+enum class Errc { bad };
+
+Result< int, Errc > parse(int x)
+{
+    if (x < 0)
+        return Err(Errc::bad);
+    return Ok(x);
+}
+
+Result< int, Errc > sum(int a, int b)
+{
+    int x = co_await parse(a);
+    int y = co_await parse(b);
+    co_return Ok(x + y);
+}
+
+Result< void, Errc > check_all(int a, int b)
+{
+    co_await parse(a);
+    co_await sum(a, b);
+    co_return Ok();
+}
+
+Result< std::unique_ptr< int >, Errc > boxed(int x)
+{
+    Result< std::unique_ptr< int >, Errc > p = Ok(std::make_unique< int >(co_await parse(x)));
+    auto owned = co_await std::move(p);
+    co_return Ok(std::move(owned));
+}
+
+// Awaiting an lvalue copies it and leaves the awaited Result intact
+Result< std::size_t, Errc > lengths(Result< std::string, Errc > & s, Result< std::string, Errc > const& c)
+{
+    std::string a = co_await s;
+    std::string b = co_await c;
+    co_return Ok(a.size() + b.size());
+}
+
+Result< int, Errc > throws(int x)
+{
+    int v = co_await parse(x);
+    if (v == 0)
+        throw std::runtime_error("zero");
+    co_return Ok(v);
+}
+
+void test_await()
+{
+    CHECK(sum(1, 2).unwrap() == 3);
+    CHECK(sum(-1, 2).unwrap_err() == Errc::bad);
+    CHECK(sum(1, -2).unwrap_err() == Errc::bad);
+    CHECK(check_all(1, 1).is_ok() && check_all(1, -1).is_err());
+    CHECK(*boxed(4).unwrap() == 4 && boxed(-4).is_err());
+}
+
+void test_lvalues()
+{
+    Result< std::string, Errc > s = Ok(std::string("abc"));
+    Result< std::string, Errc > const c = Ok(std::string("de"));
+    CHECK(lengths(s, c).unwrap() == 5);
+    CHECK(s.unwrap() == "abc" && c.unwrap() == "de");
+
+    Result< std::string, Errc > const bad = Err(Errc::bad);
+    CHECK(lengths(s, bad).unwrap_err() == Errc::bad && bad.is_err());
+}
+
+void test_frames_are_recycled()
+{
+    for (int i = 0; i < 1000; ++i)
+        CHECK(sum(i, i % 7 == 0 ? -1 : 1).is_ok() == (i % 7 != 0));
+}
+
+void test_exception()
+{
+    bool threw = false;
+    try
+    {
+        (void)throws(0);
+    }
+    catch (std::runtime_error const&)
+    {
+        threw = true;
+    }
+    CHECK(threw && throws(2).unwrap() == 2);
+}
+
+} /* namespace */
+
+int main()
+{
+    test_await();
+    test_lvalues();
+    test_frames_are_recycled();
+    test_exception();
+}
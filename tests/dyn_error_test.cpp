@@ -0,0 +1,84 @@
+#include "result_dyn_error.hpp"
+
+#include "check.hpp"
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace {
+
+enum class DbError { missing = 3 };
+
+struct ParseError
+{
+    int line;
+    std::string message() const { return "parse error on line " + std::to_string(line); }
+};
+
+// Too big for the inline buffer
+struct Big
+{
+    char bytes[64];
+    std::unique_ptr< int > owned;
+};
+
+Result< int, ParseError > parse(int x)
+{
+    if (x < 0)
+        return Err(ParseError{ -x });
+    return Ok(x);
+}
+
+Result< int, DbError > lookup(int x)
+{
+    if (x == 0)
+        return Err(DbError::missing);
+    return Ok(x * 10);
+}
+
+Result< int, DynError > handle(int x)
+{
+    int v = TRY(parse(x));
+    int row = TRY(lookup(v));
+    return Ok(row);
+}
+
+void test_boundary()
+{
+    CHECK(handle(2).unwrap() == 20);
+
+    auto parse_err = handle(-4);
+    CHECK(parse_err.unwrap_err().is< ParseError >());
+    CHECK(parse_err.unwrap_err().downcast< ParseError >()->line == 4);
+    CHECK(parse_err.unwrap_err().message() == "parse error on line 4");
+    CHECK(!parse_err.unwrap_err().downcast< DbError >());
+
+    auto db_err = handle(0);
+    CHECK(db_err.unwrap_err().downcast< DbError >() && db_err.unwrap_err().message() == "error 3");
+}
+
+void test_storage()
+{
+    DynError big = DynError::make< Big >();
+    big.downcast< Big >()->owned = std::make_unique< int >(7);
+    DynError moved = std::move(big);
+    CHECK(big.empty() && !moved.empty());
+    CHECK(*moved.downcast< Big >()->owned == 7);
+
+    DynError s = std::string("text");
+    DynError e = std::runtime_error("boom");
+    CHECK(s.message() == "text" && e.message() == "boom");
+    s = std::move(e);
+    CHECK(s.is< std::runtime_error >() && e.empty());
+    CHECK(e.message().empty());
+}
+
+} /* namespace */
+
+int main()
+{
+    test_boundary();
+    test_storage();
+}
@@ -0,0 +1,103 @@
+#include "result.hpp"
+#if defined(__cpp_impl_coroutine)
+#include "result_coro.hpp"
+#endif
+
+#include "check.hpp"
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr unsigned leaf_line = __LINE__ + 5;
+Result< int, int > leaf(int x)
+{
+    if (x % 3 != 0)
+        return Ok(x);
+    return Err(x);
+}
+
+constexpr unsigned mid_line = __LINE__ + 3;
+Result< int, int > mid(int x)
+{
+    TRY_ASSIGN(int v, leaf(x));
+    return Ok(v + 1);
+}
+
+Result< void, int > top(int x)
+{
+    TRY_VOID(mid(x));
+    return Ok();
+}
+
+ErrorSiteCount const * find(std::vector< ErrorSiteCount > const& sites, unsigned line, ErrorEvent event)
+{
+    for (auto const& s : sites)
+        if (s.location.line == line && s.event == event)
+            return &s;
+    return nullptr;
+}
+
+void test_counts_across_threads()
+{
+    std::vector< std::thread > threads;
+    for (int t = 0; t < 4; ++t)
+        threads.emplace_back([] { for (int i = 0; i < 300; ++i) (void)top(i); });
+    for (int i = 0; i < 30; ++i)
+        (void)top(i);
+    for (auto& t : threads)
+        t.join();
+
+    // Exited threads are folded into the totals
+    auto sites = error_site_counts();
+    CHECK(sites.size() == 3);
+    auto const * created = find(sites, leaf_line, ErrorEvent::created);
+    auto const * propagated = find(sites, mid_line, ErrorEvent::propagated);
+    CHECK(created && created->count == 4 * 100 + 10);
+    CHECK(propagated && propagated->count == created->count);
+    CHECK(sites[0].count >= sites[2].count);
+}
+
+void test_prometheus()
+{
+    std::ostringstream os;
+    write_error_sites_prometheus(os, "errs");
+    std::string text = os.str();
+    CHECK(text.find("# TYPE errs counter") != std::string::npos);
+    CHECK(text.find("errs{event=\"created\"") != std::string::npos);
+    CHECK(text.find("line=\"" + std::to_string(mid_line) + "\"") != std::string::npos);
+}
+
+#if defined(__cpp_impl_coroutine)
+constexpr unsigned await_line = __LINE__ + 3;
+Result< int, int > awaited(int x)
+{
+    int v = co_await leaf(x);
+    co_return Ok(v);
+}
+
+// A co_await that propagates counts like a TRY at its own line
+void test_co_await()
+{
+    (void)awaited(1);
+    (void)awaited(3);
+    (void)awaited(6);
+    auto sites = error_site_counts();
+    auto const * propagated = find(sites, await_line, ErrorEvent::propagated);
+    CHECK(propagated && propagated->count == 2);
+}
+#else
+void test_co_await() {}
+#endif
+
+} /* namespace */
+
+int main()
+{
+    test_counts_across_threads();
+    test_prometheus();
+    test_co_await();
+}
@@ -0,0 +1,112 @@
+// Compile-time checks: the layouts other code is sized against, and
+// Results of literal payloads in constant expressions. Built as C++17 and
+// as C++20; running the binary does nothing.
+
+#include "result.hpp"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace {
+
+enum class Errc { bad_digit = 1, out_of_range };
+
+struct Node;
+
+// Size budgets of the common instantiations. Errors grow by the return
+// trace under RESULT_TRACE, so only the triviality pins hold there.
+#if !defined(RESULT_TRACE)
+static_assert(result_layout< int, int >::size == 2 * sizeof(int));
+static_assert(result_layout< void, int >::size == 2 * sizeof(int));
+static_assert(result_layout< int &, void >::size == sizeof(int *));
+static_assert(result_layout< int &, void >::niche_packed);
+
+static_assert(result_layout< int, Errc >::size == 8);
+static_assert(result_layout< int, Errc >::alignment == 4);
+static_assert(result_layout< int, Errc >::overhead == 4);
+static_assert(!result_layout< int, Errc >::niche_packed);
+
+static_assert(result_layout< void, Errc >::size == 8);
+static_assert(result_layout< void, Errc >::overhead == 4);
+
+// Raw pointers have no niche, so the tag takes a word of its own
+static_assert(result_layout< Node *, Errc >::size == 2 * sizeof(void *));
+static_assert(result_layout< Node *, Errc >::alignment == alignof(void *));
+static_assert(!result_layout< Node *, Errc >::niche_packed);
+static_assert(result_fits_v< Node *, Errc, 16 >);
+
+// One tag plus padding on top of the string, whatever its ABI
+static_assert(result_layout< std::string, Errc >::size == sizeof(std::string) + alignof(std::string));
+static_assert(result_layout< std::string, Errc >::overhead == alignof(std::string));
+#if defined(_LIBCPP_VERSION) && UINTPTR_MAX == UINT64_MAX
+static_assert(result_layout< std::string, Errc >::size == 32);
+#elif defined(__GLIBCXX__) && UINTPTR_MAX == UINT64_MAX && _GLIBCXX_USE_CXX11_ABI
+static_assert(result_layout< std::string, Errc >::size == 40);
+#endif
+#endif
+
+static_assert(result_layout< int, int >::trivially_copyable);
+static_assert(result_layout< int, Errc >::trivially_copyable);
+static_assert(result_layout< void, Errc >::trivially_copyable);
+static_assert(result_layout< Node *, Errc >::trivially_copyable);
+static_assert(!result_layout< std::string, int >::trivially_copyable);
+static_assert(!result_layout< std::string, Errc >::trivially_destructible);
+
+constexpr bool combinators()
+{
+    Result< int, int > r(in_place_err, 1);
+    r.emplace_ok(2);
+    Result< void, int > v = r.map([](int x) { return x * 2; }).and_then([](int x) -> Result< void, int >
+    {
+        if (x != 4)
+            return Err(x);
+        return Ok();
+    });
+    return v.is_ok() && r == Ok(2) && r.or_else([](int e) { return Result< int, long >(in_place_err, e); }).unwrap() == 2;
+}
+static_assert(combinators());
+
+// A parse/validate pipeline evaluated at compile time
+constexpr Result< int, Errc > parse_digit(char c)
+{
+    if (c < '0' || c > '9')
+        return Err(Errc::bad_digit);
+    return Ok(c - '0');
+}
+
+constexpr Result< int, Errc > parse_port(std::string_view s)
+{
+    Result< int, Errc > acc = Ok(0);
+    for (char c : s)
+        acc = acc.and_then([c](int n) { return parse_digit(c).map([n](int d) { return n * 10 + d; }); });
+    return acc.and_then([](int n) -> Result< int, Errc >
+    {
+        if (n == 0 || n > 65535)
+            return Err(Errc::out_of_range);
+        return Ok(n);
+    });
+}
+
+static_assert(parse_port("8080") == Ok(8080));
+static_assert(parse_port("80a0") == Err(Errc::bad_digit));
+static_assert(parse_port("70000") == Err(Errc::out_of_range));
+static_assert(parse_port("x").unwrap_or(-1) == -1);
+
+// A lookup table built from Results
+constexpr std::array< int, 4 > ports = []
+{
+    constexpr std::string_view in[] = { "22", "80", "bad", "443" };
+    std::array< int, 4 > out{};
+    for (std::size_t i = 0; i < out.size(); ++i)
+        out[i] = parse_port(in[i]).unwrap_or(0);
+    return out;
+}();
+static_assert(ports[0] == 22 && ports[1] == 80 && ports[2] == 0 && ports[3] == 443);
+
+} /* namespace */
+
+int main()
+{
+}
@@ -0,0 +1,76 @@
+#include "result_lazy.hpp"
+
+#include "check.hpp"
+
+#include <memory>
+#include <string>
+#include <type_traits>
+
+namespace {
+
+enum class Errc { bad };
+
+Result< int, Errc > parse(int x)
+{
+    if (x < 0)
+        return Err(Errc::bad);
+    return Ok(x);
+}
+
+void test_matches_eager()
+{
+    auto dbl = [](int x) { return x * 2; };
+    auto check = [](int x) -> Result< int, Errc >
+    {
+        if (x > 100)
+            return Err(Errc::bad);
+        return Ok(x);
+    };
+    auto name = [](Errc) { return std::string("bad"); };
+
+    for (int x : { -1, 3, 60 })
+    {
+        auto eager = parse(x).map(dbl).and_then(check).map_err(name);
+        Result< int, std::string > fused = parse(x).lazy()
+            | lazy::map(dbl)
+            | lazy::and_then(check)
+            | lazy::map_err(name);
+        CHECK(fused == eager);
+    }
+}
+
+void test_types()
+{
+    auto pipe = parse(1).lazy()
+        | lazy::map([](int x) { return std::to_string(x); })
+        | lazy::map([](std::string const&) {});
+    static_assert(std::is_same_v< decltype(pipe)::result_type, Result< void, Errc > >);
+    CHECK(std::move(pipe).eval().is_ok());
+}
+
+void test_error_stages_only_on_err()
+{
+    int map_calls = 0, err_calls = 0;
+    Result< int, int > r = parse(-1).lazy()
+        | lazy::map([&](int x) { ++map_calls; return x; })
+        | lazy::map_err([&](Errc) { ++err_calls; return 7; })
+        | lazy::or_else([](int e) { return Result< int, int >(in_place_ok, e + 1); });
+    CHECK(map_calls == 0 && err_calls == 1 && r == Ok(8));
+}
+
+void test_move_only()
+{
+    Result< std::unique_ptr< int >, Errc > p = Ok(std::make_unique< int >(5));
+    Result< int, Errc > r = std::move(p).lazy() | lazy::map([](std::unique_ptr< int > u) { return *u; });
+    CHECK(r.unwrap() == 5);
+}
+
+} /* namespace */
+
+int main()
+{
+    test_matches_eager();
+    test_types();
+    test_error_stages_only_on_err();
+    test_move_only();
+}
@@ -0,0 +1,49 @@
+// Compile-time checks of the accessors' exception specifications under a
+// non-throwing panic policy (RESULT_PANIC_ABORT is set by the build). An
+// accessor returning by value is only noexcept when moving the payload out
+// cannot throw.
+
+#include "result.hpp"
+
+#include <string>
+#include <utility>
+
+namespace {
+
+struct ThrowingMove
+{
+    ThrowingMove() = default;
+    ThrowingMove(ThrowingMove const&) = default;
+    ThrowingMove(ThrowingMove&&) noexcept(false) {}
+};
+
+using Plain = Result< std::string, int >;
+using Throwing = Result< ThrowingMove, ThrowingMove >;
+
+static_assert(details::panic_noexcept, "RESULT_PANIC_ABORT is expected");
+
+static_assert(noexcept(std::declval< Plain& >().unwrap()));
+static_assert(noexcept(std::declval< Plain const& >().unwrap_err()));
+static_assert(noexcept(std::declval< Plain >().unwrap()));
+static_assert(noexcept(std::declval< Plain >().unwrap_err()));
+static_assert(noexcept(std::declval< Plain >().expect("")));
+static_assert(noexcept(std::declval< Plain >().expect_err("")));
+
+// References into the Result stay noexcept
+static_assert(noexcept(std::declval< Throwing& >().unwrap()));
+static_assert(noexcept(std::declval< Throwing const& >().expect_err("")));
+
+static_assert(!noexcept(std::declval< Throwing >().unwrap()));
+static_assert(!noexcept(std::declval< Throwing >().unwrap_err()));
+static_assert(!noexcept(std::declval< Throwing >().expect("")));
+static_assert(!noexcept(std::declval< Throwing >().expect_err("")));
+static_assert(!noexcept(std::declval< Throwing >().unwrap_unchecked()));
+
+static_assert(noexcept(std::declval< Result< void, int > >().unwrap()));
+static_assert(noexcept(std::declval< Result< int &, int > >().unwrap()));
+
+} /* namespace */
+
+int main()
+{
+}
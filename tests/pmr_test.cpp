@@ -0,0 +1,68 @@
+#include "result_pmr.hpp"
+
+#include "check.hpp"
+
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <utility>
+#include <vector>
+
+// The common alias must not clash with the library's names
+namespace pmr = std::pmr;
+
+namespace {
+
+enum class Errc { bad };
+
+using String = pmr::string;
+
+constexpr char const * long_text = "a string long enough to need a heap allocation";
+
+static_assert(std::uses_allocator_v< Result< String, Errc >, std::pmr::polymorphic_allocator< char > >);
+static_assert(std::uses_allocator_v< Result< int, String >, std::pmr::polymorphic_allocator< char > >);
+static_assert(!std::uses_allocator_v< Result< int, Errc >, std::pmr::polymorphic_allocator< char > >);
+
+void test_factories()
+{
+    std::pmr::monotonic_buffer_resource arena;
+    auto ok = result_pmr::make_ok< String, Errc >(&arena, long_text);
+    CHECK(ok.unwrap() == long_text && ok.unwrap().get_allocator().resource() == &arena);
+
+    auto err = result_pmr::make_err< int, String >(&arena, 60, 'x');
+    CHECK(err.unwrap_err().size() == 60 && err.unwrap_err().get_allocator().resource() == &arena);
+
+    CHECK(result_pmr::make_ok< void, String >(&arena).is_ok());
+    CHECK(result_pmr::make_ok< int, Errc >(&arena, 3).unwrap() == 3);
+
+    std::pmr::unsynchronized_pool_resource other;
+    auto copy = result_pmr::rebind(&other, ok);
+    CHECK(copy.unwrap() == long_text && copy.unwrap().get_allocator().resource() == &other);
+    auto moved = result_pmr::rebind(&other, std::move(err));
+    CHECK(moved.unwrap_err().get_allocator().resource() == &other);
+}
+
+void test_container()
+{
+    std::pmr::monotonic_buffer_resource arena;
+    std::pmr::vector< Result< String, Errc > > v(&arena);
+
+    Result< String, Errc > outside = Ok(String(long_text));
+    CHECK(outside.unwrap().get_allocator().resource() != &arena);
+    v.push_back(outside);
+    v.push_back(std::move(outside));
+    v.emplace_back(Ok(String(long_text)));
+    v.emplace_back(Err(Errc::bad));
+
+    for (std::size_t i = 0; i < 3; ++i)
+        CHECK(v[i].unwrap().get_allocator().resource() == &arena);
+    CHECK(v[3].is_err());
+}
+
+} /* namespace */
+
+int main()
+{
+    test_factories();
+    test_container();
+}
@@ -0,0 +1,184 @@
+#include "result.hpp"
+
+#include "check.hpp"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace {
+
+enum class Errc { bad, worse };
+
+Result< int, Errc > parse(int x)
+{
+    if (x < 0)
+        return Err(Errc::bad);
+    return Ok(x);
+}
+
+Result< int, Errc > twice(int x)
+{
+    int v = TRY(parse(x));
+    return Ok(v * 2);
+}
+
+// TRY's temporary must neither clash with nor shadow a caller's name
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic error "-Wshadow"
+#endif
+Result< int, Errc > named_res(int x)
+{
+    auto res = parse(x);
+    int v = TRY(std::move(res));
+    int w = TRY(twice(TRY(parse(v))));
+    return Ok(w + 1);
+}
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+
+Result< void, Errc > check_positive(int x)
+{
+    TRY_VOID(parse(x));
+    return Ok();
+}
+
+Result< int, Errc > assign(int x)
+{
+    int v = 0;
+    TRY_ASSIGN(v, parse(x));
+    return Ok(v + 1);
+}
+
+void test_construction()
+{
+    Result< int, Errc > ok = Ok(1);
+    Result< int, Errc > err = Err(Errc::bad);
+    CHECK(ok.is_ok() && !ok.is_err());
+    CHECK(err.is_err() && !err.is_ok());
+    CHECK(ok.unwrap() == 1);
+    CHECK(err.unwrap_err() == Errc::bad);
+
+    Result< std::string, Errc > s(in_place_ok, 3, 'x');
+    CHECK(s.unwrap() == "xxx");
+    s.emplace_err(Errc::worse);
+    CHECK(s.is_err() && s.unwrap_err() == Errc::worse);
+    s.emplace_ok("y");
+    CHECK(s.unwrap() == "y");
+
+    Result< void, Errc > v = Ok();
+    CHECK(v.is_ok());
+    Result< int, void > e = Err();
+    CHECK(e.is_err());
+}
+
+void test_accessors()
+{
+    Result< int, Errc > ok = Ok(4);
+    Result< int, Errc > err = Err(Errc::bad);
+    CHECK(ok.unwrap_or(0) == 4 && err.unwrap_or(0) == 0);
+    CHECK(err.unwrap_or_default() == 0);
+    CHECK(err.unwrap_or_else([](Errc) { return 9; }) == 9);
+    CHECK(ok.ok() == 4 && !err.ok());
+    CHECK(err.err() == Errc::bad && !ok.err());
+    CHECK(ok.value_ptr() && *ok.value_ptr() == 4 && !ok.error_ptr());
+    CHECK(ok.expect("has value") == 4);
+    CHECK(*ok == 4 && ok.unwrap_unchecked() == 4);
+
+    Result< std::string, Errc > s = Ok(std::string("abc"));
+    CHECK(s->size() == 3);
+    s.as_mut().unwrap() += "d";
+    CHECK(s.as_ref().unwrap() == "abcd");
+}
+
+void test_combinators()
+{
+    auto inc = [](int x) { return x + 1; };
+    CHECK(parse(1).map(inc) == Ok(2));
+    CHECK(parse(-1).map(inc) == Err(Errc::bad));
+    CHECK(parse(-1).map_err([](Errc) { return 5; }) == Err(5));
+    CHECK(parse(3).and_then(twice) == Ok(6));
+    CHECK(parse(-1).or_else([](Errc) { return parse(7); }) == Ok(7));
+    CHECK(parse(1).and_(parse(2)) == Ok(2));
+    CHECK(parse(-1).or_(parse(2)) == Ok(2));
+
+    Result< std::unique_ptr< int >, Errc > p = Ok(std::make_unique< int >(3));
+    auto q = std::move(p).map([](std::unique_ptr< int > u) { return *u * 2; });
+    CHECK(q.unwrap() == 6);
+}
+
+// A consumed Result keeps its alternative and holds a moved-from payload
+void test_moved_from()
+{
+    Result< int, std::unique_ptr< int > > r = Err(std::make_unique< int >(42));
+    auto m = std::move(r).map([](int x) { return x + 1; });
+    CHECK(*m.unwrap_err() == 42);
+    CHECK(r.is_err() && !r.is_ok());
+    CHECK(std::move(r).err().value() == nullptr);
+
+    Result< std::unique_ptr< int >, Errc > p = Ok(std::make_unique< int >(7));
+    auto e = std::move(p).map_err([](Errc) { return 0; });
+    CHECK(*e.unwrap() == 7);
+    CHECK(p.is_ok() && p.unwrap() == nullptr);
+    p = Err(Errc::worse);
+    CHECK(p == Err(Errc::worse));
+}
+
+void test_try()
+{
+    CHECK(twice(2) == Ok(4));
+    CHECK(twice(-2) == Err(Errc::bad));
+    CHECK(check_positive(1).is_ok() && check_positive(-1).is_err());
+    CHECK(assign(1) == Ok(2) && assign(-1) == Err(Errc::bad));
+    CHECK(named_res(3) == Ok(7) && named_res(-1) == Err(Errc::bad));
+}
+
+struct Unhashable {};
+
+// std::hash is only enabled when both payloads hash
+static_assert(std::is_default_constructible_v< std::hash< Result< void, Errc > > >);
+static_assert(std::is_default_constructible_v< std::hash< Result< int const&, Errc > > >);
+static_assert(!std::is_default_constructible_v< std::hash< Result< Unhashable, Errc > > >);
+static_assert(!std::is_copy_constructible_v< std::hash< Result< int, Unhashable > > >);
+
+void test_comparison()
+{
+    CHECK(parse(1) == parse(1));
+    CHECK(parse(1) != parse(2));
+    CHECK(parse(1) != parse(-1));
+    CHECK(parse(-1) == Err(Errc::bad));
+    CHECK(std::hash< Result< int, Errc > >{}(parse(1)) == std::hash< Result< int, Errc > >{}(parse(1)));
+}
+
+#if RESULT_HAS_EXCEPTIONS && !defined(RESULT_PANIC_ABORT) && !defined(RESULT_PANIC_HANDLER)
+void test_panic()
+{
+    bool threw = false;
+    try
+    {
+        (void)parse(-1).unwrap();
+    }
+    catch (std::logic_error const&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+}
+#else
+void test_panic() {}
+#endif
+
+} /* namespace */
+
+int main()
+{
+    test_construction();
+    test_accessors();
+    test_combinators();
+    test_moved_from();
+    test_try();
+    test_comparison();
+    test_panic();
+}
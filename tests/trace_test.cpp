@@ -0,0 +1,174 @@
+#include "result.hpp"
+#include "result_algorithm.hpp"
+#include "result_lazy.hpp"
+#include "result_parallel.hpp"
+#if defined(__cpp_impl_coroutine)
+#include "result_coro.hpp"
+#endif
+
+#include "check.hpp"
+
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr unsigned leaf_line = __LINE__ + 5;
+Result< int, std::string > leaf(int x)
+{
+    if (x >= 0)
+        return Ok(x);
+    return Err(std::string("negative"));
+}
+
+constexpr unsigned mid_line = __LINE__ + 3;
+Result< int, std::string > mid(int x)
+{
+    TRY_ASSIGN(int v, leaf(x));
+    return Ok(v);
+}
+
+constexpr unsigned top_line = __LINE__ + 3;
+Result< long, std::string > top(int x)
+{
+    long v = TRY(mid(x));
+    return Ok(v);
+}
+
+constexpr unsigned mapped_line = __LINE__ + 3;
+Result< void, int > mapped(int x)
+{
+    TRY_VOID(top(x).map_err([](std::string s) { return int(s.size()); }));
+    return Ok();
+}
+
+constexpr unsigned deep_line = __LINE__ + 6;
+Result< int, int > deep(int n)
+{
+    if (n == 0)
+        return Err(1);
+    int v = 0;
+    TRY_ASSIGN(v, deep(n - 1));
+    return Ok(v);
+}
+
+void test_hops()
+{
+    auto r = mapped(-1);
+    auto const& t = r.return_trace();
+    CHECK(t.origin().line == leaf_line);
+    CHECK(t.size() == 3 && t.dropped() == 0);
+    CHECK(t[0].line == mid_line && t[1].line == top_line && t[2].line == mapped_line);
+    CHECK(r.unwrap_err() == 8);
+}
+
+void test_depth()
+{
+    auto r = deep(20);
+    auto const& t = r.return_trace();
+    CHECK(t.size() == RESULT_TRACE_DEPTH && t.dropped() == 20 - RESULT_TRACE_DEPTH);
+    CHECK(t[0].line == deep_line && t.origin().line == deep_line - 2);
+}
+
+void test_combinators_keep_trace()
+{
+    auto r = mid(-1);
+    auto m = std::move(r).map([](int x) { return x + 1; }).and_then([](int x) { return leaf(x); });
+    CHECK(m.return_trace().origin().line == leaf_line && m.return_trace().size() == 1);
+
+    Result< int, std::unique_ptr< int > > u = Err(std::make_unique< int >(3));
+    auto u2 = std::move(u).map([](int x) { return x; });
+    CHECK(*u2.unwrap_err() == 3 && u2.return_trace().origin().line != 0);
+
+    Result< int, std::string > copy = m;
+    CHECK(copy.return_trace().size() == 1);
+}
+
+void test_lazy_keeps_trace()
+{
+    Result< int, std::size_t > r = mid(-1).lazy()
+        | lazy::map([](int x) { return x + 1; })
+        | lazy::map_err([](std::string s) { return s.size(); })
+        | lazy::and_then([](int x) { return Result< int, std::size_t >(Ok(x)); });
+    CHECK(r.unwrap_err() == 8);
+    CHECK(r.return_trace().origin().line == leaf_line && r.return_trace().size() == 1);
+    CHECK(r.return_trace()[0].line == mid_line);
+
+    // An error raised by a stage brings its own trace
+    Result< int, std::string > s = leaf(1).lazy()
+        | lazy::and_then([](int) { return mid(-1); });
+    CHECK(s.return_trace().origin().line == leaf_line && s.return_trace().size() == 1);
+}
+
+void test_algorithms_keep_trace()
+{
+    std::vector< Result< int, std::string > > in{ leaf(1), mid(-1), leaf(2) };
+    auto c = collect(in);
+    CHECK(c.return_trace().origin().line == leaf_line && c.return_trace().size() == 1);
+    auto moved = collect(std::move(in));
+    CHECK(moved.unwrap_err() == "negative" && moved.return_trace().size() == 1);
+
+    std::vector< int > xs{ 1, 2, -3, 4 };
+    auto t = try_transform(xs, mid);
+    CHECK(t.return_trace().origin().line == leaf_line && t.return_trace()[0].line == mid_line);
+
+    std::vector< int > many(100000, 1);
+    many[777] = -1;
+    auto p = try_transform(result_execution::par, many, mid);
+    CHECK(p.return_trace().origin().line == leaf_line && p.return_trace().size() == 1);
+}
+
+void test_allocator_copies_keep_trace()
+{
+    Result< int, std::string > r = mid(-1);
+    std::allocator< char > alloc;
+    Result< int, std::string > copied(std::allocator_arg, alloc, r);
+    CHECK(copied.return_trace().origin().line == leaf_line && copied.return_trace().size() == 1);
+    Result< int, std::string > moved(std::allocator_arg, alloc, std::move(r));
+    CHECK(moved.unwrap_err() == "negative" && moved.return_trace()[0].line == mid_line);
+
+    std::pmr::polymorphic_allocator< char > pmr_alloc;
+    constexpr unsigned err_line = __LINE__ + 1;
+    Result< int, std::pmr::string > wrapped(std::allocator_arg, pmr_alloc, Err(std::pmr::string("x")));
+    CHECK(wrapped.return_trace().origin().line == err_line);
+
+    // pmr containers copy their elements through the allocator constructor
+    std::pmr::vector< Result< int, std::pmr::string > > v;
+    v.push_back(wrapped);
+    CHECK(v[0].return_trace().origin().line == err_line);
+}
+
+#if defined(__cpp_impl_coroutine)
+constexpr unsigned await_line = __LINE__ + 3;
+Result< int, std::string > awaited(int x)
+{
+    int v = co_await mid(x);
+    co_return Ok(v);
+}
+
+void test_co_await_records_hop()
+{
+    auto r = awaited(-1);
+    auto const& t = r.return_trace();
+    CHECK(t.origin().line == leaf_line && t.size() == 2);
+    CHECK(t[0].line == mid_line && t[1].line == await_line);
+}
+#else
+void test_co_await_records_hop() {}
+#endif
+
+} /* namespace */
+
+int main()
+{
+    test_hops();
+    test_depth();
+    test_combinators_keep_trace();
+    test_lazy_keeps_trace();
+    test_algorithms_keep_trace();
+    test_allocator_copies_keep_trace();
+    test_co_await_records_hop();
+}
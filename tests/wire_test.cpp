@@ -0,0 +1,107 @@
+#include "result_wire.hpp"
+
+#include "check.hpp"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+enum class Errc : std::uint32_t { bad = 9 };
+
+struct Point
+{
+    std::int32_t x, y;
+};
+
+void test_fixed()
+{
+    auto ok = WireResult< Point, Errc >::encode(Result< Point, Errc >(in_place_ok, Point{ 1, 2 }));
+    auto err = WireResult< Point, Errc >::encode(Result< Point, Errc >(in_place_err, Errc::bad));
+    CHECK(ok.header.tag == 1 && ok.header.length == sizeof(Point));
+    CHECK(err.header.tag == 2 && err.header.length == sizeof(Errc));
+
+    auto again = WireResult< Point, Errc >::encode(Result< Point, Errc >(in_place_ok, Point{ 1, 2 }));
+    CHECK(std::memcmp(&ok, &again, sizeof(ok)) == 0);
+
+    auto view = wire_view< Point, Errc >(&ok, sizeof(ok)).unwrap();
+    CHECK(view.is_ok() && view.value_ptr()->y == 2 && !view.error_ptr());
+    CHECK(view.load().unwrap().x == 1);
+    CHECK(wire_view< Point, Errc >(&err, sizeof(err)).unwrap().load().unwrap_err() == Errc::bad);
+
+    auto v = WireResult< void, Errc >::encode(Result< void, Errc >(in_place_ok));
+    CHECK(v.header.length == 0 && wire_view< void, Errc >(&v, sizeof(v)).unwrap().load().is_ok());
+}
+
+struct Padded
+{
+    char c;
+    std::int32_t x;
+};
+
+// Bytewise equality only holds for payloads without padding
+static_assert(WireResult< Point, Errc >::unique_representation);
+static_assert(WireResult< void, Errc >::unique_representation);
+static_assert(!WireResult< Padded, Errc >::unique_representation);
+static_assert(!WireResult< float, Errc >::unique_representation);
+
+void test_zeroed()
+{
+    // The bytes after a shorter active side are zero
+    auto err = WireResult< Point, Errc >::encode(Result< Point, Errc >(in_place_err, Errc::bad));
+    unsigned char const zero[sizeof(Point) - sizeof(Errc)] = {};
+    CHECK(std::memcmp(err.payload + sizeof(Errc), zero, sizeof(zero)) == 0);
+    CHECK(err.header.reserved == 0);
+
+    auto p = WireResult< Padded, Errc >::encode(Result< Padded, Errc >(in_place_ok, Padded{ 'a', 7 }));
+    CHECK(wire_view< Padded, Errc >(&p, sizeof(p)).unwrap().load().unwrap().x == 7);
+}
+
+void test_validation()
+{
+    auto ok = WireResult< Point, Errc >::encode(Result< Point, Errc >(in_place_ok, Point{ 1, 2 }));
+    CHECK(wire_view< Point, Errc >(&ok, 8).unwrap_err() == WireErrc::truncated);
+    CHECK(wire_view< Point, Errc >(&ok, sizeof(WireHeader) + 4).unwrap_err() == WireErrc::truncated);
+
+    auto bad = ok;
+    bad.header.tag = 3;
+    CHECK(wire_view< Point, Errc >(&bad, sizeof(bad)).unwrap_err() == WireErrc::bad_header);
+    bad = ok;
+    bad.header.reserved = 1;
+    CHECK(wire_view< Point, Errc >(&bad, sizeof(bad)).unwrap_err() == WireErrc::bad_header);
+    bad = ok;
+    bad.header.length = 4;
+    CHECK(wire_view< Point, Errc >(&bad, sizeof(bad)).unwrap_err() == WireErrc::bad_length);
+}
+
+void test_gather()
+{
+    Result< std::string, Errc > res = Ok(std::string("hello"));
+    WireHeader header;
+    WireSegment segs[4];
+    CHECK(wire_segment_count(res) == 2);
+    CHECK(wire_gather(res, header, segs, 1) == 0);
+    std::size_t n = wire_gather(res, header, segs, 4);
+    CHECK(n == 2 && header.tag == 1 && header.length == 5);
+
+    std::vector< unsigned char > buf;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        auto const * p = static_cast< unsigned char const * >(segs[i].data);
+        buf.insert(buf.end(), p, p + segs[i].size);
+    }
+    auto view = wire_view< std::string, Errc >(buf.data(), buf.size()).unwrap();
+    CHECK(view.is_ok() && view.payload_size() == 5);
+    CHECK(std::string(reinterpret_cast< char const * >(view.payload()), view.payload_size()) == "hello");
+}
+
+} /* namespace */
+
+int main()
+{
+    test_fixed();
+    test_zeroed();
+    test_validation();
+    test_gather();
+}